@@ -1,19 +1,53 @@
+#include <fcntl.h>
 #include <stdint.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <list>
 #include <memory>
-#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 enum class TileType {
@@ -43,7 +77,14 @@ constexpr static void set(BitBoard& board, int x, int y) {
 constexpr static void unset(BitBoard& board, int x, int y) {
     board &= ~(1 << (x * 5 + y));
 }
-std::pmr::monotonic_buffer_resource resource;
+
+constexpr static void set(BitBoard& board, int cell) {
+    board |= (1 << cell);
+}
+
+constexpr static const std::tuple<char, TileType, bool>& tile_at(const Board& board, int cell) {
+    return board[cell / 5][cell % 5];
+}
 
 using Path = std::vector<std::tuple<int, int, char>>;
 
@@ -112,45 +153,158 @@ constexpr static int letter_type_to_mul(TileType tile_type) {
     return 1;
 }
 
+// the most a word with these letter points can score when the best letter lands on the best letter multiplier
+constexpr static int get_max_score(int letter_points, int max_letter_score, int word_len, bool has_double_word, TileType tile_type) {
+    int upper_bound = letter_points;
+    upper_bound += max_letter_score * (letter_type_to_mul(tile_type) - 1);
+    upper_bound *= (has_double_word ? 2 : 1);
+    upper_bound += (word_len >= 6 ? 10 : 0);
+
+    return upper_bound;
+}
+
+// get_mods() can only come up with a word multiplier or not, times no, double or triple letter
+constexpr int N_PROFILES = 6;
+
+constexpr static size_t mod_profile(bool has_double_word, TileType tile_type) {
+    return (has_double_word ? 3 : 0) + letter_type_to_mul(tile_type) - 1;
+}
+
 constexpr static int get_max_score(const std::string_view key, bool has_double_word, TileType tile_type) {
-    int upper_bound = 0;
+    int letter_points = 0;
     int max_letter_score = 0;
 
     for (char c : key) {
-        upper_bound += char_to_points(c);
+        letter_points += char_to_points(c);
         max_letter_score = std::max(max_letter_score, char_to_points(c));
     }
 
-    upper_bound += max_letter_score * (letter_type_to_mul(tile_type) - 1);
-    upper_bound *= (has_double_word ? 2 : 1);
-    upper_bound += (key.size() >= 6 ? 10 : 0);
-
-    return upper_bound;
+    return get_max_score(letter_points, max_letter_score, key.size(), has_double_word, tile_type);
 }
 
 constexpr int N = 26;
+
+// position of child `index` among the children present in `bitfield`
+constexpr static uint32_t child_rank(uint32_t bitfield, size_t index) {
+    return std::popcount(bitfield & ((1u << index) - 1));
+}
+
+// nothing in a node depends on the board, the same trie can be searched on any board
 class TrieNode {
    public:
     uint32_t bitfield = 0;
-    uint8_t max_score = 0;
+    // index of the first child in Trie::edges, the others follow in letter order
+    uint32_t children = 0;
+    // maxima over every word through this node, each one possibly from a different word
+    uint8_t max_letter_points = 0;
+    uint8_t max_letter_score = 0;
+    uint8_t max_word_len = 0;
+    // the shortest word through this node
+    uint8_t min_word_len = UINT8_MAX;
     bool isEndOfWord = false;
-    std::array<TrieNode*, N> children{};
+    // letters every word through this node still has to spell after it, as bits like `bitfield`
+    uint32_t required_letters = UINT32_MAX;
+    // the best get_max_score() of a word through this node for every mod_profile()
+    std::array<uint8_t, N_PROFILES> max_score{};
+};
+
+// every node lives in one contiguous pool and is referred to by its 32 bit index,
+// a node only stores as many child indices as it has children
+class Trie {
+   public:
+    static constexpr uint32_t root = 0;
+
+    std::vector<TrieNode> nodes{1};
+    std::vector<uint32_t> edges;
 
-    static void TrieInsert(TrieNode* x, const std::string_view key, const uint8_t max_score) {
+    uint32_t child(uint32_t node, size_t index) const {
+        const TrieNode& n = nodes[node];
+        return edges[n.children + child_rank(n.bitfield, index)];
+    }
+
+    size_t bytes() const {
+        return nodes.size() * sizeof(TrieNode) + edges.capacity() * sizeof(uint32_t);
+    }
+
+    void TrieInsert(const std::string_view key) {
+        int letter_points = 0;
+        int max_letter_score = 0;
         for (const char c : key) {
-            x->max_score = std::max(x->max_score, max_score);
+            letter_points += char_to_points(c);
+            max_letter_score = std::max(max_letter_score, char_to_points(c));
+        }
+        std::array<uint8_t, N_PROFILES> max_score;
+        for (bool has_double_word : {false, true})
+            for (TileType tile_type : {TileType::Normal, TileType::DoubleLetter, TileType::TripleLetter}) {
+                const int profile_score = get_max_score(letter_points, max_letter_score, key.size(), has_double_word, tile_type);
+                [[unlikely]] if (profile_score > 255 || key.size() > 255) {
+                    throw std::runtime_error("max score is too big");
+                }
+                max_score[mod_profile(has_double_word, tile_type)] = profile_score;
+            }
+
+        // letters of the word from each position on
+        std::array<uint32_t, 256> suffix_letters;
+        suffix_letters[key.size()] = 0;
+        for (size_t i = key.size(); i-- > 0;)
+            suffix_letters[i] = suffix_letters[i + 1] | (char_to_index(key[i]) < N ? 1u << char_to_index(key[i]) : 0);
+
+        uint32_t x = root;
+        for (size_t depth = 0; const char c : key) {
+            update_bounds(nodes[x], letter_points, max_letter_score, key.size(), max_score);
+            nodes[x].required_letters &= suffix_letters[depth++];
 
             size_t index = char_to_index(c);
-            if (index < x->children.size()) [[likely]] {
-                if (!(x->bitfield & (1 << index))) {
-                    x->bitfield |= (1 << index);
-                    x->children[index] = new (resource.allocate(sizeof(TrieNode), alignof(TrieNode)))(TrieNode);
-                }
-                x = x->children[index];
+            if (index < N) [[likely]] {
+                if (!(nodes[x].bitfield & (1 << index)))
+                    add_child(x, index);
+                x = child(x, index);
             }
         }
-        x->isEndOfWord = true;
-        x->max_score = std::max(x->max_score, max_score);
+        nodes[x].isEndOfWord = true;
+        nodes[x].required_letters = 0;
+        update_bounds(nodes[x], letter_points, max_letter_score, key.size(), max_score);
+    }
+
+    // lays the child arrays out again without the gaps add_child() leaves behind
+    void compact() {
+        std::vector<uint32_t> packed;
+        packed.reserve(nodes.size() - 1);
+        for (TrieNode& node : nodes) {
+            const uint32_t first = packed.size();
+            packed.insert(packed.end(), edges.begin() + node.children, edges.begin() + node.children + std::popcount(node.bitfield));
+            node.children = first;
+        }
+        edges = std::move(packed);
+    }
+
+   private:
+    static void update_bounds(TrieNode& node, int letter_points, int max_letter_score, size_t word_len, const std::array<uint8_t, N_PROFILES>& max_score) {
+        node.max_letter_points = std::max<int>(node.max_letter_points, letter_points);
+        node.max_letter_score = std::max<int>(node.max_letter_score, max_letter_score);
+        node.max_word_len = std::max<int>(node.max_word_len, word_len);
+        node.min_word_len = std::min<int>(node.min_word_len, word_len);
+        for (size_t i = 0; i < N_PROFILES; ++i)
+            node.max_score[i] = std::max(node.max_score[i], max_score[i]);
+    }
+
+    // child arrays hold a power of two slots, a full one is moved to the end of `edges` at twice the size
+    void add_child(uint32_t x, size_t index) {
+        const uint32_t count = std::popcount(nodes[x].bitfield);
+        if (count == 0 || std::has_single_bit(count)) {
+            const uint32_t moved_to = edges.size();
+            edges.resize(edges.size() + std::max(1u, count * 2));
+            std::copy_n(edges.begin() + nodes[x].children, count, edges.begin() + moved_to);
+            nodes[x].children = moved_to;
+        }
+
+        const uint32_t rank = child_rank(nodes[x].bitfield, index);
+        const auto first = edges.begin() + nodes[x].children;
+        std::copy_backward(first + rank, first + count, first + count + 1);
+        first[rank] = nodes.size();
+
+        nodes[x].bitfield |= (1 << index);
+        nodes.emplace_back();
     }
 };
 
@@ -186,27 +340,167 @@ constexpr static int score(const Board& board, const Path& path) {
     return score;
 }
 
-constexpr static std::pair<std::array<std::pair<int, int>, 8>, int> get_neighbors(const Path& path, const BitBoard& bboard, int cur_x, int cur_y) {
-    std::pair<std::array<std::pair<int, int>, 8>, int> neighbors;
+constexpr static int gems(const Board& board, const Path& path) {
+    int gems = 0;
+    for (auto& [x, y, c] : path)
+        gems += std::get<2>(board[x][y]) ? 1 : 0;
+    return gems;
+}
+
+// a Path in three words and no allocation: every tile is its cell index + 1 in 5 bits, so a zero marks the end,
+// and only the letters of swapped tiles are kept, the others are read back off the board
+class PackedPath {
+   public:
+    static constexpr int max_swaps = 7;
 
-    const std::array<std::pair<const int, const int>, 8> offsets = {{{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
-    for (auto& [ox, oy] : offsets) {
-        int x = ox + cur_x;
-        int y = oy + cur_y;
+    constexpr auto operator<=>(const PackedPath&) const = default;
 
-        if (x < 0 || x >= 5 || y < 0 || y >= 5) {
-            continue;
+    // `index` is the position in the word, it has to be the next free one
+    constexpr void push(int index, int cell, char letter, bool swapped) {
+        set_bits(index * 5, cell + 1);
+        if (swapped) {
+            swaps |= static_cast<uint64_t>(char_to_index(letter)) << (25 + std::popcount(swaps & swap_mask) * 5);
+            swaps |= 1ull << index;
         }
+    }
+
+    constexpr int size() const {
+        const int bits = cells[1] ? 64 + std::bit_width(cells[1]) : std::bit_width(cells[0]);
+        return (bits + 4) / 5;
+    }
+
+    constexpr int cell(int index) const {
+        return get_bits(index * 5) - 1;
+    }
+
+    Path unpack(const Board& board) const {
+        Path path;
+        for (int i = 0, swapped = 0; i < size(); ++i)
+            path.emplace_back(cell(i) / 5, cell(i) % 5, letter(board, i, swapped));
+        return path;
+    }
+
+    // the word's letters packed like the cells, two paths spell the same word when these are equal
+    constexpr std::array<uint64_t, 2> letters(const Board& board) const {
+        PackedPath word;
+        for (int i = 0, swapped = 0; i < size(); ++i)
+            word.set_bits(i * 5, char_to_index(letter(board, i, swapped)) + 1);
+        return word.cells;
+    }
+
+   private:
+    static constexpr uint64_t swap_mask = (1ull << 25) - 1;
+
+    // the letter at `index`, `swapped` counts the swapped tiles before it and has to be walked through in order
+    constexpr char letter(const Board& board, int index, int& swapped) const {
+        if (swaps & (1ull << index))
+            return 'a' + ((swaps >> (25 + swapped++ * 5)) & 31);
+        return std::get<0>(tile_at(board, cell(index)));
+    }
 
-        if (!get(bboard, x, y)) {
-            neighbors.first[neighbors.second] = {x, y};
-            neighbors.second++;
+    // 25 tiles * 5 bits spread over both words, tile 12 straddles them
+    constexpr void set_bits(int offset, uint64_t value) {
+        if (offset < 64) {
+            cells[0] |= value << offset;
+            if (offset + 5 > 64)
+                cells[1] |= value >> (64 - offset);
+        } else {
+            cells[1] |= value << (offset - 64);
         }
     }
 
-    return neighbors;
+    constexpr int get_bits(int offset) const {
+        uint64_t value;
+        if (offset < 64) {
+            value = cells[0] >> offset;
+            if (offset + 5 > 64)
+                value |= cells[1] << (64 - offset);
+        } else {
+            value = cells[1] >> (offset - 64);
+        }
+        return value & 31;
+    }
+
+    std::array<uint64_t, 2> cells{};
+    // bit i is set when tile i was swapped, the letters of the swapped tiles follow in 5 bits each from bit 25
+    uint64_t swaps = 0;
+};
+
+// cells are numbered x * 5 + y, the same bit they have in a BitBoard
+constexpr static std::array<BitBoard, 25> make_adjacency() {
+    std::array<BitBoard, 25> adjacency{};
+    for (int x = 0; x < 5; ++x)
+        for (int y = 0; y < 5; ++y)
+            for (int ox = -1; ox <= 1; ++ox)
+                for (int oy = -1; oy <= 1; ++oy) {
+                    const int nx = x + ox;
+                    const int ny = y + oy;
+                    if ((ox || oy) && nx >= 0 && nx < 5 && ny >= 0 && ny < 5)
+                        set(adjacency[x * 5 + y], nx, ny);
+                }
+    return adjacency;
+}
+
+// the neighbors of every cell, walking the bits lowest first visits them in the old offset order
+constexpr static std::array<BitBoard, 25> adjacency = make_adjacency();
+
+constexpr BitBoard FULL_BOARD = (1u << 25) - 1;
+
+// every neighbor of a cell in `cells`, a few shifts instead of a table lookup per bit
+constexpr static BitBoard neighbors(BitBoard cells) {
+    constexpr BitBoard first_column = 0b00001'00001'00001'00001'00001;
+    constexpr BitBoard last_column = first_column << 4;
+    const BitBoard sideways = ((cells & ~last_column) << 1) | ((cells & ~first_column) >> 1);
+    const BitBoard row = cells | sideways;
+    return (sideways | (row << 5) | (row >> 5)) & FULL_BOARD;
+}
+
+// every cell in `cells` plus all of their neighbors
+constexpr static BitBoard expand(BitBoard cells) {
+    return cells | neighbors(cells);
 }
 
+// the unvisited cells a path ending on `cell` can still get to without crossing itself
+constexpr static BitBoard reachable(int cell, BitBoard bboard) {
+    const BitBoard free = ~bboard & FULL_BOARD;
+    BitBoard reach = adjacency[cell] & free;
+    for (BitBoard grown = expand(reach) & free; grown != reach; grown = expand(reach) & free)
+        reach = grown;
+    return reach;
+}
+
+// where the modifiers sit on the board
+struct BoardMasks {
+    BitBoard double_letter = 0;
+    BitBoard triple_letter = 0;
+    BitBoard double_word = 0;
+    BitBoard gems = 0;
+    // the letter on every cell as a bit like a node's bitfield
+    std::array<uint32_t, 25> letters{};
+
+    explicit BoardMasks(const Board& board) {
+        for (int cell = 0; cell < 25; ++cell) {
+            if (const size_t index = char_to_index(std::get<0>(tile_at(board, cell))); index < N)
+                letters[cell] = 1u << index;
+            if (std::get<2>(tile_at(board, cell)))
+                set(gems, cell);
+            switch (std::get<1>(tile_at(board, cell))) {
+                case TileType::DoubleLetter:
+                    set(double_letter, cell);
+                    break;
+                case TileType::TripleLetter:
+                    set(triple_letter, cell);
+                    break;
+                case TileType::DoubleWord:
+                    set(double_word, cell);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
 // made for debugging purposes
 /*
 static void print_path(Path& path, bool isEndOfWord) {
@@ -220,287 +514,2400 @@ static void print_path(Path& path, bool isEndOfWord) {
 */
 
 struct RecurseParams {
+    PackedPath path;
     BitBoard bboard;
+    // where the path ends
+    int cell;
+    // letter points of the path without any multiplier
+    int letter_points;
     int current_word_points;
     int current_eco_points;
     int word_len;
     int swaps;
     bool has_word_mul;
-    bool eco_mode;
 
-    void update(const int x, const int y, const char c, const TileType tile_type, bool has_gem) {
+    void update(const int next_cell, const char c, const TileType tile_type, bool has_gem, bool swapped) {
+        path.push(word_len, next_cell, c, swapped);
+        letter_points += char_to_points(c);
         current_eco_points += has_gem ? 1 : 0;
         current_word_points += char_to_points(c) * letter_type_to_mul(tile_type);
         has_word_mul |= tile_type == TileType::DoubleWord;
         word_len++;
-        set(bboard, x, y);
-        swaps--;
+        set(bboard, next_cell);
+        cell = next_cell;
+        swaps -= swapped ? 1 : 0;
     }
 };
 
-// optimized implementation, hard to read, will refactor later
-static void recurse(const Board& board, Path& path, const RecurseParams params, int& max_eco_score, int& max_score, const TrieNode* node, std::vector<Path>& largest_word) {
-    if (node->max_score <= max_score)
-        return;
+// the most the letters still to come after a node can add, before any multiplier, how many there are
+// and which of them every word below the node needs
+struct SuffixBound {
+    int letter_points;
+    int max_letter_score;
+    int max_len;
+    int min_len;
+    uint32_t required_letters;
+};
+
+// how recurse() sees a dictionary: children as a bitfield, child lookup by letter, end of word flags,
+// an upper bound on the score of any word below a node given the path so far and what the rest of the word can add
+struct TrieDict {
+    using Node = uint32_t;
 
-    // print_path(path, node->isEndOfWord);
-    const auto [x, y, c] = path.back();
+    const Trie& trie;
+    Node root;
+    // mod_profile() of the board
+    size_t profile;
 
-    const auto [neighbors, n_neighbors] = get_neighbors(path, params.bboard, x, y);
+    size_t size() const {
+        return trie.nodes.size();
+    }
 
-    for (const auto& [x1, y1] : neighbors | std::views::take(n_neighbors)) {
-        const size_t reserved_index = char_to_index(std::get<0>(board[x1][y1]));
-        TrieNode* next_node{};
+    uint32_t children(Node node) const {
+        return trie.nodes[node].bitfield;
+    }
 
-        if (params.swaps > 0) {
-            for (size_t i = 0; i < N; ++i) {
-                if (!(node->bitfield & (1 << i)) || i == reserved_index)
-                    continue;
+    Node child(Node node, size_t index) const {
+        return trie.child(node, index);
+    }
 
-                RecurseParams params_copy = params;
-                params_copy.update(x1, y1, i + 'a', std::get<1>(board[x1][y1]), std::get<2>(board[x1][y1]));
-                next_node = node->children.at(i);
+    bool is_end(Node node) const {
+        return trie.nodes[node].isEndOfWord;
+    }
 
-                path.emplace_back(x1, y1, i + 'a');
-                recurse(board, path, params_copy, max_eco_score, max_score, next_node, largest_word);
-                path.pop_back();
-            }
-        }
+    int bound(Node node, const RecurseParams& params) const {
+        return bound(node, params.current_word_points, params.word_len);
+    }
 
-        if (node->bitfield & (1 << reserved_index)) {
-            RecurseParams params_copy = params;
-            params_copy.update(x1, y1, std::get<0>(board[x1][y1]), std::get<1>(board[x1][y1]), std::get<2>(board[x1][y1]));
-            params_copy.swaps++;
-            next_node = node->children.at(reserved_index);
-
-            path.emplace_back(x1, y1, std::get<0>(board[x1][y1]));
-            recurse(board, path, params_copy, max_eco_score, max_score, next_node, largest_word);
-            path.pop_back();
-        }
-    }
-
-    if (node->isEndOfWord) {
-        const int eco_score = params.current_eco_points;
-        const int our_score = params.current_word_points * (params.has_word_mul ? 2 : 1) + (params.word_len >= 6 ? 10 : 0);
-        if (params.eco_mode) {
-            if (eco_score > max_eco_score) {
-                largest_word.clear();
-                largest_word.emplace_back(path);
-                max_score = our_score;
-                max_eco_score = eco_score;
-            } else if (eco_score == max_eco_score) {
-                if (our_score > max_score) {
-                    largest_word.clear();
-                    largest_word.emplace_back(path);
-                    max_score = our_score;
-                    max_eco_score = eco_score;
-                } else if (our_score == max_score) {
-                    largest_word.emplace_back(path);
-                }
-            }
-        }
+    // the same from just the columns breadth_search() keeps
+    int bound(Node node, int, int) const {
+        return trie.nodes[node].max_score[profile];
+    }
+
+    // a trie node knows its prefix, so whatever the best word through it has beyond the path is the rest
+    SuffixBound suffix(Node node, const RecurseParams& params) const {
+        const TrieNode& n = trie.nodes[node];
+        return {n.max_letter_points - params.letter_points, n.max_letter_score, n.max_word_len - params.word_len, n.min_word_len - params.word_len, n.required_letters};
+    }
+};
 
-        else if (our_score > max_score) {
-            largest_word.clear();
-            largest_word.emplace_back(path);
-            max_score = our_score;
-            max_eco_score = eco_score;
-        } else if (our_score == max_score) {
-            largest_word.emplace_back(path);
+// minimized DAWG, equal suffixes are stored once so a node no longer knows the prefix that led to it.
+// its bounds only describe the rest of the word and are added to the points the path already has
+class Dawg {
+   public:
+    struct Node {
+        uint32_t bitfield = 0;
+        // index of the first child in `edges`, the others follow in letter order
+        uint32_t children = 0;
+        // best letter point sum of the remaining letters
+        uint8_t max_suffix_points = 0;
+        uint8_t max_suffix_letter = 0;
+        uint8_t max_suffix_len = 0;
+        // 0 on a word end, otherwise how far the closest one is
+        uint8_t min_suffix_len = 0;
+        bool isEndOfWord = false;
+        // letters every suffix below this node contains, none on a word end
+        uint32_t required_letters = 0;
+    };
+
+    // point either into the vectors below or straight into a mapped dictionary file
+    std::span<const Node> nodes;
+    std::span<const uint32_t> edges;
+    uint32_t root = 0;
+
+    Dawg() = default;
+    Dawg(Dawg&&) = default;
+    Dawg& operator=(Dawg&&) = default;
+
+    static Dawg build(const Trie& trie) {
+        Dawg dawg;
+        std::unordered_map<std::vector<uint32_t>, uint32_t, SignatureHash> registry;
+        dawg.root = dawg.minimize(trie, Trie::root, registry);
+        dawg.nodes = dawg.owned_nodes;
+        dawg.edges = dawg.owned_edges;
+        return dawg;
+    }
+
+    // the file is the header followed by the node and edge arrays as they are in memory, every reference in
+    // them is an index so it can be mapped anywhere. it remembers the size and mtime of the word list it came from
+    void save(const char* path, const char* wordlist_path) const {
+        struct stat wordlist_stat{};
+        if (stat(wordlist_path, &wordlist_stat) != 0)
+            throw std::runtime_error(std::format("can't stat {}", wordlist_path));
+
+        FileHeader header{};
+        header.wordlist_size = wordlist_stat.st_size;
+        header.wordlist_mtime = wordlist_stat.st_mtim.tv_sec * 1'000'000'000ll + wordlist_stat.st_mtim.tv_nsec;
+        header.root = root;
+        header.node_count = nodes.size();
+        header.edge_count = edges.size();
+
+        // written next to the real file first so a crash never leaves half a dictionary behind
+        const std::string tmp_path = std::format("{}.tmp", path);
+        {
+            std::ofstream file(tmp_path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(nodes.data()), nodes.size_bytes());
+            file.write(reinterpret_cast<const char*>(edges.data()), edges.size_bytes());
+            if (!file)
+                throw std::runtime_error(std::format("can't write {}", tmp_path));
         }
+        std::filesystem::rename(tmp_path, path);
     }
-}
 
-// default word, should be overridden by recurse, also should be refactored out
+    // maps a file written by save(), nullopt when it's missing, from an older build or older than the word list
+    static std::optional<Dawg> load(const char* path, const char* wordlist_path) {
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return std::nullopt;
+
+        struct stat file_stat{};
+        void* data = MAP_FAILED;
+        if (fstat(fd, &file_stat) == 0 && static_cast<size_t>(file_stat.st_size) >= sizeof(FileHeader))
+            data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return std::nullopt;
+
+        Dawg dawg;
+        dawg.mapping = {data, static_cast<size_t>(file_stat.st_size)};
+
+        const FileHeader& header = *static_cast<const FileHeader*>(data);
+        if (header.magic != FileHeader{}.magic || header.version != FileHeader{}.version)
+            return std::nullopt;
+        if (sizeof(FileHeader) + header.node_count * sizeof(Node) + header.edge_count * sizeof(uint32_t) != dawg.mapping.size)
+            return std::nullopt;
+
+        // a word list that's gone is fine, one that changed since the compile is not
+        if (struct stat wordlist_stat{}; stat(wordlist_path, &wordlist_stat) == 0) {
+            const int64_t mtime = wordlist_stat.st_mtim.tv_sec * 1'000'000'000ll + wordlist_stat.st_mtim.tv_nsec;
+            if (header.wordlist_size != static_cast<uint64_t>(wordlist_stat.st_size) || header.wordlist_mtime != mtime)
+                return std::nullopt;
+        }
 
-static Board parse_board_from_file() {
-    std::ifstream board_file("board.txt");
+        const char* arrays = static_cast<const char*>(data) + sizeof(FileHeader);
+        dawg.nodes = {reinterpret_cast<const Node*>(arrays), header.node_count};
+        dawg.edges = {reinterpret_cast<const uint32_t*>(arrays + header.node_count * sizeof(Node)), header.edge_count};
+        dawg.root = header.root;
+        return dawg;
+    }
 
-    Board board{};
-    int i = 0;
+    size_t bytes() const {
+        return nodes.size() * sizeof(Node) + edges.size() * sizeof(uint32_t);
+    }
 
-    for (std::string line; std::getline(board_file, line);) {
-        auto letters = std::views::split(line, ' ');
-        auto v = std::views::zip(letters, std::views::iota(0)) | std::views::take(5);
+    uint32_t child(uint32_t node, size_t index) const {
+        const Node& n = nodes[node];
+        return edges[n.children + child_rank(n.bitfield, index)];
+    }
 
-        for (auto [letter, e] : v) {
-            TileType tile_type = TileType::Normal;
-            bool has_gem = false;
-            for (size_t c = 1; c < letter.size(); ++c) {
-                if (!std::isalpha(letter[c]))
-                    continue;
-                switch (letter[c]) {
-                    case 'l':
-                        tile_type = TileType::DoubleLetter;
-                        break;
-                    case 't':
-                        tile_type = TileType::TripleLetter;
-                        break;
-                    case 'w':
-                        tile_type = TileType::DoubleWord;
-                        break;
-                    case 'i':
-                        tile_type = TileType::Ice;
-                        break;
-                    case 'g':
-                        has_gem = true;
-                        break;
-                    default:
-                        break;
-                }
-            }
-            board[i][e] = {letter[0], tile_type, has_gem};
+   private:
+    struct FileHeader {
+        std::array<char, 8> magic = {'S', 'H', 'A', 'K', 'D', 'A', 'W', 'G'};
+        // bump whenever Node changes
+        uint32_t version = 3;
+        uint32_t root = 0;
+        uint64_t wordlist_size = 0;
+        int64_t wordlist_mtime = 0;
+        uint64_t node_count = 0;
+        uint64_t edge_count = 0;
+    };
+
+    struct Mapping {
+        void* data = nullptr;
+        size_t size = 0;
+
+        Mapping() = default;
+        Mapping(void* data, size_t size) : data(data), size(size) {}
+        Mapping(Mapping&& other) : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+        Mapping& operator=(Mapping&& other) {
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+            return *this;
         }
-        i++;
+        ~Mapping() {
+            if (data)
+                munmap(data, size);
+        }
+    };
+
+    std::vector<Node> owned_nodes;
+    std::vector<uint32_t> owned_edges;
+    Mapping mapping;
+
+    struct SignatureHash {
+        size_t operator()(const std::vector<uint32_t>& signature) const {
+            size_t hash = signature.size();
+            for (uint32_t v : signature)
+                hash ^= v + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    // children first, then the node is looked up by (flags, child ids): two trie nodes with the same
+    // letters leading to the same minimized children are the same suffix and share one DAWG node
+    uint32_t minimize(const Trie& trie, uint32_t trie_index, std::unordered_map<std::vector<uint32_t>, uint32_t, SignatureHash>& registry) {
+        const TrieNode& trie_node = trie.nodes[trie_index];
+        std::vector<uint32_t> signature = {trie_node.bitfield << 1 | trie_node.isEndOfWord};
+        for (size_t i = 0; i < N; ++i)
+            if (trie_node.bitfield & (1 << i))
+                signature.push_back(minimize(trie, trie.child(trie_index, i), registry));
+
+        if (auto it = registry.find(signature); it != registry.end())
+            return it->second;
+
+        Node node{};
+        node.bitfield = trie_node.bitfield;
+        node.isEndOfWord = trie_node.isEndOfWord;
+        node.children = owned_edges.size();
+        node.min_suffix_len = trie_node.isEndOfWord ? 0 : UINT8_MAX;
+        node.required_letters = trie_node.isEndOfWord ? 0 : UINT32_MAX;
+        int max_suffix_points = 0;
+        for (size_t i = 0, c = 1; i < N; ++i) {
+            if (!(trie_node.bitfield & (1 << i)))
+                continue;
+            const Node& child = owned_nodes[signature[c++]];
+            const int letter_points = char_to_points(i + 'a');
+            max_suffix_points = std::max(max_suffix_points, letter_points + child.max_suffix_points);
+            node.max_suffix_letter = std::max<int>({node.max_suffix_letter, letter_points, child.max_suffix_letter});
+            node.max_suffix_len = std::max<int>(node.max_suffix_len, child.max_suffix_len + 1);
+            node.min_suffix_len = std::min<int>(node.min_suffix_len, child.min_suffix_len + 1);
+            node.required_letters &= 1u << i | child.required_letters;
+        }
+        [[unlikely]] if (max_suffix_points > 255) {
+            throw std::runtime_error("max score is too big");
+        }
+        node.max_suffix_points = max_suffix_points;
+        owned_edges.insert(owned_edges.end(), signature.begin() + 1, signature.end());
+
+        const uint32_t index = owned_nodes.size();
+        owned_nodes.push_back(node);
+        registry.emplace(std::move(signature), index);
+        return index;
     }
+};
 
-    return board;
-}
+// the DAWG as recurse() sees it, the board's modifiers turn the suffix data into a score bound
+struct DawgDict {
+    using Node = uint32_t;
 
-static void print_biggest_word(const Board& board, std::vector<Path>& biggest_words) {
-    for (auto& words : std::views::reverse(biggest_words) | std::views::take(10)) {
-        std::cout << "board: " << std::endl;
-        for (int i = 0; i < 5; ++i) {
-            for (int j = 0; j < 5; j++) {
-                auto it = std::ranges::find_if(words, [i, j](const auto& path) {
-                    auto [x, y, c] = path;
-                    return x == i && y == j;
-                });
-                const char c = std::get<0>(board[i][j]);
+    const Dawg& dawg;
+    Node root;
+    bool has_word_mod;
+    TileType max_letter_mod;
 
-                if (it != words.end()) {
-                    {
-                        char it_c = std::get<2>(*it);
-                        bool first = it == words.begin();
-                        if (it_c != c)
-                        // make the brackets red
-                        {
-                            std::cout << std::format("\033[1;31m[\033[0m");
+    size_t size() const {
+        return dawg.nodes.size();
+    }
 
-                            if (first)
-                                // color this green
-                                std::cout << std::format("\033[1;32m{}\033[0m", it_c);
-                            else
-                                std::cout << std::format("\033[1;31m{}\033[0m", it_c);
+    uint32_t children(Node node) const {
+        return dawg.nodes[node].bitfield;
+    }
 
-                            std::cout << std::format("\033[1;31m]\033[0m");
-                        } else
-                            // make the text white
-                            if (first)
-                                // color this green
-                                std::cout << std::format("\033[1;32m[{}]\033[0m", it_c);
-                            else
-                                std::cout << std::format("\033[1;37m[{}]\033[0m", it_c);
-                    }
-                } else
-                    std::cout << std::format(" {} ", c);
-            }
-            std::cout << std::endl;
-            std::cout << std::endl;
-        }
-        std::cout << "word found: ";
-        for (auto [x, y, c] : words)
-            std::cout << c;
-        std::cout << std::endl;
+    Node child(Node node, size_t index) const {
+        return dawg.child(node, index);
+    }
 
-        for (auto [x, y, c] : words)
-            std::cout << std::format("({}, {}, {}), ", x, y, c);
-        std::cout << std::endl;
+    bool is_end(Node node) const {
+        return dawg.nodes[node].isEndOfWord;
+    }
 
-        std::cout << "score: " << score(board, words) << std::endl;
-        std::cout << std::endl;
+    // get_max_score() over the rest of the word, with the points already on the path taken as they are
+    int bound(Node node, const RecurseParams& params) const {
+        return bound(node, params.current_word_points, params.word_len);
     }
-}
 
-static std::pair<bool, TileType> get_mods(const Board& board) {
-    TileType max_letter_mod = TileType::Normal;
-    bool has_word_mod = false;
-    for (auto& row : board)
-        for (auto& [letter, tile_type, has_gem] : row)
-            if (tile_type == TileType::DoubleLetter)
-                max_letter_mod = max_letter_mod == TileType::Normal ? TileType::DoubleLetter : max_letter_mod;
-            else if (tile_type == TileType::TripleLetter)
-                max_letter_mod = TileType::TripleLetter;
-            else if (tile_type == TileType::DoubleWord)
-                has_word_mod = true;
+    int bound(Node node, int word_points, int word_len) const {
+        const Dawg::Node& n = dawg.nodes[node];
+        return get_max_score(word_points + n.max_suffix_points, n.max_suffix_letter, word_len + n.max_suffix_len, has_word_mod, max_letter_mod);
+    }
 
-    return {has_word_mod, max_letter_mod};
-}
+    SuffixBound suffix(Node node, const RecurseParams&) const {
+        const Dawg::Node& n = dawg.nodes[node];
+        return {n.max_suffix_points, n.max_suffix_letter, n.max_suffix_len, n.min_suffix_len, n.required_letters};
+    }
+};
 
-int main(int argc, char* argv[]) {
-    std::cout << "STARTED PROGRAM" << std::endl;
-    TrieNode* root =
-        new (resource.allocate(sizeof(TrieNode), alignof(TrieNode)))(TrieNode);
+// best (eco, score) seen by any thread, packed into one word so a single CAS keeps the pair consistent.
+// in eco mode the gems sit above the points so the packed keys compare the same way recurse ranks words.
+// the search only prunes what can't even tie it, so every thread gets to every tie of the final best word
+// whatever order the tasks ran in, and what it reports doesn't depend on timing
+class SharedBest {
+   public:
+    explicit SharedBest(bool eco_mode) : eco_mode(eco_mode) {}
 
-    Board board = parse_board_from_file();
-    auto [has_word_mod, max_letter_mod] = get_mods(board);
+    int64_t pack(int eco_score, int score) const {
+        return (eco_mode ? static_cast<int64_t>(eco_score) << 16 : 0) | score;
+    }
 
-    std::ifstream wordlist_file("wordlist.txt");
-    std::ifstream swaps_file("swaps.txt");
-    std::ifstream eco_file("eco.txt");
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        std::string word;
-        while (wordlist_file >> word) {
-            if (std::ranges::any_of(word, [](const auto& c) { return !std::isalpha(c); }))
-                continue;
-            int max_score = get_max_score(word, has_word_mod, max_letter_mod);
-            // get max score based on word or something
-            [[unlikely]] if (max_score > 255) {
-                throw std::runtime_error("max score is too big");
-            }
+    int64_t key() const {
+        return best_key.load(std::memory_order_relaxed);
+    }
 
-            TrieNode::TrieInsert(root, word, max_score);
-        }
+    int score() const {
+        return key() & 0xffff;
+    }
 
-        auto end = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        std::cout << std::format("elapsed time: {}ms", elapsed.count() / 1000.) << std::endl;
+    void raise(int64_t key) {
+        int64_t current = best_key.load(std::memory_order_relaxed);
+        while (current < key && !best_key.compare_exchange_weak(current, key, std::memory_order_relaxed))
+            ;
     }
 
-    const int swaps = std::stoi(std::string{std::istreambuf_iterator<char>(swaps_file), std::istreambuf_iterator<char>()});
-    bool eco_mode = std::stoi(std::string{std::istreambuf_iterator<char>(eco_file), std::istreambuf_iterator<char>()});
-    std::vector<Path> biggest_words = {{{{0, 0, 'e'}}}};
-    int max_eco_score = 0;
-    int max_score = 0;
+   private:
+    std::atomic<int64_t> best_key{0};
+    bool eco_mode;
+};
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < 5; ++i)
-        for (int j = 0; j < 5; ++j)
-            if (swaps > 0)
-                for (int a = 'a'; a <= 'z'; ++a) {
-                    Path path = {{i, j, a}};
-                    RecurseParams params{};
-                    params.update(i, j, a, std::get<1>(board[i][j]), std::get<2>(board[i][j]));
-
-                    int swaps_left = swaps;
-                    if (a != std::get<0>(board[i][j]))
-                        swaps_left--;
-                    params.swaps = swaps_left;
-                    params.eco_mode = eco_mode;
-
-                    path.reserve(25);
-                    if (root->bitfield & 1 << (a - 'a')) [[likely]]
-                        recurse(board, path, params, max_eco_score, max_score, root->children.at(char_to_index(a)), biggest_words);
-                }
-            else {
-                Path path = {{i, j, std::get<0>(board[i][j])}};
-                RecurseParams params{};
-                params.update(i, j, std::get<0>(board[i][j]), std::get<1>(board[i][j]), std::get<2>(board[i][j]));
-                params.swaps = 0;
-                params.eco_mode = eco_mode;
+// words found by one thread, only the ones tied with `key` are kept
+struct SearchResults {
+    int64_t key = 0;
+    std::vector<PackedPath> largest_word;
+};
+
+// the best `capacity` words, never two with the same letters on the same cells, words with the same key ranked by their
+// paths so the ones kept don't depend on the order they were found in. once it's full the worst of them is the bar a
+// word has to reach, it goes into SharedBest so the search prunes against it like against the best word
+class TopWords {
+   public:
+    TopWords(size_t capacity, SharedBest& best) : capacity(capacity), best(best) {
+        heap.reserve(capacity);
+    }
+
+    void add(const Board& board, int64_t key, const PackedPath& path, BitBoard cells) {
+        const std::array<uint64_t, 2> word = path.letters(board);
+        const Entry entry{key, path, cells, word};
+
+        std::lock_guard lock(mutex);
+        if (heap.size() == capacity && !worse(heap.front(), entry))
+            return;
 
-                path.reserve(25);
-                if (root->bitfield & 1 << (std::get<0>(board[i][j]) - 'a')) [[likely]]
-                    recurse(board, path, params, max_eco_score, max_score, root->children.at(char_to_index(std::get<0>(board[i][j]))), biggest_words);
+        if (auto it = std::ranges::find_if(heap, [&](const Entry& e) { return e.cells == cells && e.word == word; }); it != heap.end()) {
+            if (worse(*it, entry)) {
+                *it = entry;
+                std::ranges::make_heap(heap, better);
             }
+        } else if (heap.size() < capacity) {
+            heap.push_back(entry);
+            std::ranges::push_heap(heap, better);
+        } else {
+            std::ranges::pop_heap(heap, better);
+            heap.back() = entry;
+            std::ranges::push_heap(heap, better);
+        }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    std::cout << std::format("elapsed time: {}ms", elapsed.count() / 1000.) << std::endl;
+        if (heap.size() == capacity)
+            best.raise(heap.front().key);
+    }
 
-    print_biggest_word(board, biggest_words);
-    std::cout << "max score: " << max_score << std::endl;
-    std::cout << "max eco score: " << max_eco_score << std::endl;
+    // worst first, like the ties the plain search returns are printed from the back
+    std::vector<Path> sorted(const Board& board) const {
+        std::vector<Entry> entries = heap;
+        std::ranges::sort(entries, worse);
+
+        std::vector<Path> words;
+        for (const Entry& entry : entries)
+            words.push_back(entry.path.unpack(board));
+        return words;
+    }
+
+   private:
+    struct Entry {
+        int64_t key;
+        PackedPath path;
+        BitBoard cells;
+        // PackedPath::letters()
+        std::array<uint64_t, 2> word;
+    };
+
+    static bool worse(const Entry& a, const Entry& b) {
+        return std::tie(a.key, a.path) < std::tie(b.key, b.path);
+    }
+
+    // the heap keeps the worst entry in front
+    static bool better(const Entry& a, const Entry& b) {
+        return worse(b, a);
+    }
+
+    size_t capacity;
+    SharedBest& best;
+    std::mutex mutex;
+    std::vector<Entry> heap;
+};
+
+// how much a gem and a spent swap are worth in points, as given on the command line or in a --serve request
+struct Weights {
+    // the largest weight either way. WeightedValue rounds them to thousandths of a point and packs them into int64 keys
+    static constexpr double max = 1000;
+
+    double gem = 0;
+    double swap = 0;
+};
+
+// weights that fit a WeightedValue, nan and inf included in what's thrown for
+static Weights checked_weights(double gem, double swap) {
+    if (!(std::abs(gem) <= Weights::max && std::abs(swap) <= Weights::max))
+        throw std::runtime_error(std::format("weights have to be from {} to {}", -Weights::max, Weights::max));
+    return Weights{gem, swap};
+}
+
+// ranks words by points + gem weight * gems - swap weight * swaps spent. the value is kept in thousandths of a point so
+// it packs into the same integer keys as the other objectives, and shifted up so even the worst word stays above 0
+class WeightedValue {
+   public:
+    static constexpr int64_t scale = 1000;
+
+    WeightedValue(const Weights& weights, int budget)
+        : gem_weight(std::llround(weights.gem * scale)), swap_weight(std::llround(weights.swap * scale)), budget(budget) {}
+
+    int swaps_used(const RecurseParams& params) const {
+        return budget - params.swaps;
+    }
+
+    int64_t value(int points, int gems, int swaps_used) const {
+        return points * scale + gem_weight * gems - swap_weight * swaps_used + offset();
+    }
+
+    // the most value() any word below the path can have, given bounds on its points and gems. a path never loses the
+    // gems or gives back the swaps it has, so each term is taken at whichever end its weight favours
+    int64_t bound(const RecurseParams& params, int max_points, int max_gems) const {
+        const int gems = gem_weight >= 0 ? max_gems : params.current_eco_points;
+        const int swaps = swap_weight >= 0 ? swaps_used(params) : budget;
+        return value(max_points, gems, swaps);
+    }
+
+   private:
+    // the lowest the gem and swap terms can go, independent of the budget so stages of a deepening search compare
+    int64_t offset() const {
+        return std::max<int64_t>(-gem_weight, 0) * 25 + std::max<int64_t>(swap_weight, 0) * PackedPath::max_swaps;
+    }
+
+    int64_t gem_weight;
+    int64_t swap_weight;
+    int budget;
+};
+
+// the words no other word beats on points, gems and swaps spent all at once, at most one for every (swaps spent, gems),
+// the one with the greater path when two tie. `dominant` has the most points of any word that spent no more swaps and
+// got no fewer gems, for every pair, which is all that pruning needs so it's read without taking the lock
+class Frontier {
+   public:
+    static constexpr int max_gems = 25;
+
+    explicit Frontier(int budget) : budget(budget) {}
+
+    int swaps_used(const RecurseParams& params) const {
+        return budget - params.swaps;
+    }
+
+    // a word with at most `score` points and `gems` gems that spent at least `swaps` swaps wouldn't add anything.
+    // a tie still could win its slot on the path, so it's searched like everything else that isn't beaten
+    bool dominates(int score, int gems, int swaps) const {
+        return dominant[swaps][std::min(gems, max_gems)].load(std::memory_order_relaxed) > score;
+    }
+
+    void add(int score, int gems, int swaps, const PackedPath& path) {
+        if (dominates(score, gems, swaps))
+            return;
+
+        std::lock_guard lock(mutex);
+        Slot& slot = words[swaps][gems];
+        if (std::tie(score, path) <= std::tie(slot.score, slot.path))
+            return;
+        slot = {score, path};
+        for (int s = swaps; s <= PackedPath::max_swaps; ++s)
+            for (int g = 0; g <= gems; ++g)
+                dominant[s][g].store(std::max(dominant[s][g].load(std::memory_order_relaxed), score), std::memory_order_relaxed);
+    }
+
+    // fewest points first, like the ties the plain search returns are printed from the back
+    std::vector<Path> sorted(const Board& board) const {
+        std::vector<std::pair<int, PackedPath>> frontier;
+        for (int s = 0; s <= PackedPath::max_swaps; ++s)
+            for (int g = 0; g <= max_gems; ++g) {
+                const Slot& slot = words[s][g];
+                if (slot.score == 0)
+                    continue;
+                // words that turned up early can be beaten by a later one from another slot
+                const bool beaten = std::ranges::any_of(std::views::iota(0, s + 1), [&](int other_s) {
+                    return std::ranges::any_of(std::views::iota(g, max_gems + 1), [&](int other_g) {
+                        return (other_s != s || other_g != g) && words[other_s][other_g].score >= slot.score;
+                    });
+                });
+                if (!beaten)
+                    frontier.emplace_back(slot.score, slot.path);
+            }
+        std::ranges::sort(frontier);
+
+        std::vector<Path> paths;
+        for (const auto& [score, path] : frontier)
+            paths.push_back(path.unpack(board));
+        return paths;
+    }
+
+   private:
+    struct Slot {
+        int score = 0;
+        PackedPath path;
+    };
+
+    int budget;
+    std::array<std::array<std::atomic<int>, max_gems + 1>, PackedPath::max_swaps + 1> dominant{};
+    std::array<std::array<Slot, max_gems + 1>, PackedPath::max_swaps + 1> words{};
+    std::mutex mutex;
+};
+
+// a time budget every thread of a search checks, the first one to see it run out stops all of them.
+// each thread only reads the clock every check_interval nodes
+class Deadline {
+   public:
+    static constexpr uint32_t check_interval = 1024;
+
+    explicit Deadline(std::chrono::milliseconds budget) : at(std::chrono::steady_clock::now() + budget) {}
+
+    // `countdown` is the calling thread's own, it says when to read the clock next
+    bool expired(uint32_t& countdown) {
+        if (--countdown == 0) {
+            countdown = check_interval;
+            if (std::chrono::steady_clock::now() >= at)
+                stop.store(true, std::memory_order_relaxed);
+        }
+        return expired();
+    }
+
+    // the same for `nodes` nodes at once, like a whole level of breadth_search()
+    bool expired(uint32_t& countdown, size_t nodes) {
+        countdown = nodes < countdown ? countdown - nodes : 1;
+        return expired(countdown);
+    }
+
+    bool expired() const {
+        return stop.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::chrono::steady_clock::time_point at;
+    std::atomic<bool> stop{false};
+};
+
+// a subtree recurse() handed off so an idle thread can pick it up, owns copies of everything it needs
+template <typename Dict>
+struct SearchTask {
+    RecurseParams params;
+    typename Dict::Node node;
+};
+
+// one deque per thread: the owner pushes and pops at the back, idle threads steal from the front,
+// so thieves take the oldest and therefore biggest subtrees
+template <typename Task>
+class TaskPool {
+   public:
+    explicit TaskPool(unsigned threads) : queues(threads) {}
+
+    // subtrees are only split off this close to the root, deeper ones are too small to be worth the copy
+    static constexpr int max_split_depth = 6;
+
+    bool hungry() const {
+        return idle.load(std::memory_order_relaxed) > 0;
+    }
+
+    void push(unsigned worker, Task task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        Queue& queue = queues[worker];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+        queue.size.fetch_add(1, std::memory_order_relaxed);
+        queued.fetch_add(1, std::memory_order_release);
+        wake();
+    }
+
+    // runs tasks until every queue is drained and no thread is still producing new ones
+    template <typename F>
+    void work(unsigned worker, F&& run) {
+        while (true) {
+            if (std::optional<Task> task = pop(worker)) {
+                run(*task);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    wake();
+                continue;
+            }
+
+            // sleeps until a task is queued or the last one finishes, the owners' mutexes are left to the owners.
+            // wakeups is read before the counts, so a wake() after that read makes wait() return straight away
+            idle.fetch_add(1, std::memory_order_relaxed);
+            for (;;) {
+                const uint32_t seen = wakeups.load(std::memory_order_acquire);
+                if (pending.load(std::memory_order_acquire) == 0 || queued.load(std::memory_order_acquire) > 0)
+                    break;
+                wakeups.wait(seen, std::memory_order_acquire);
+            }
+            idle.fetch_sub(1, std::memory_order_relaxed);
+
+            if (pending.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+   private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        // tasks.size() for thieves to look at without taking the lock
+        std::atomic<size_t> size = 0;
+    };
+
+    void wake() {
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_all();
+    }
+
+    Task take(Queue& queue, bool back) {
+        Task task = std::move(back ? queue.tasks.back() : queue.tasks.front());
+        back ? queue.tasks.pop_back() : queue.tasks.pop_front();
+        queue.size.fetch_sub(1, std::memory_order_relaxed);
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    std::optional<Task> pop(unsigned worker) {
+        {
+            Queue& own = queues[worker];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty())
+                return take(own, true);
+        }
+
+        if (queued.load(std::memory_order_acquire) == 0)
+            return std::nullopt;
+        for (size_t i = 1; i < queues.size(); ++i) {
+            Queue& victim = queues[(worker + i) % queues.size()];
+            if (victim.size.load(std::memory_order_relaxed) == 0)
+                continue;
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty())
+                return take(victim, false);
+        }
+        return std::nullopt;
+    }
+
+    std::vector<Queue> queues;
+    // tasks sitting in any of the queues
+    std::atomic<int> queued = 0;
+    // tasks pushed but not finished yet, a running task can still push more
+    std::atomic<int> pending = 0;
+    std::atomic<int> idle = 0;
+    // bumped by every push and by the last task to finish, idle threads wait on it
+    std::atomic<uint32_t> wakeups = 0;
+};
+
+// everything recurse() needs that stays the same for a whole thread
+template <typename Dict>
+struct SearchContext {
+    const Board& board;
+    const BoardMasks& masks;
+    // finish_cells() by node, empty unless --reach-prune
+    std::span<const BitBoard> finish_cells;
+    const Dict& dict;
+    SharedBest& best;
+    SearchResults& results;
+    // visit children best bound first instead of in board order
+    bool order_children;
+    // null for the single threaded search
+    TaskPool<SearchTask<Dict>>* pool;
+    unsigned worker;
+    // null when there's no time limit
+    Deadline* deadline;
+    // null when only the best word and its ties are kept
+    TopWords* top;
+    // null unless the search is for the pareto frontier
+    Frontier* frontier;
+    // null unless words are ranked by a weighted value
+    const WeightedValue* weighted;
+    uint32_t countdown = Deadline::check_interval;
+};
+
+// the search has run out of time, whatever it found so far is all there is
+template <typename Dict>
+static bool out_of_time(SearchContext<Dict>& ctx) {
+    return ctx.deadline && ctx.deadline->expired(ctx.countdown);
+}
+
+template <typename Dict>
+static bool out_of_time(SearchContext<Dict>& ctx, size_t nodes) {
+    return ctx.deadline && ctx.deadline->expired(ctx.countdown, nodes);
+}
+
+struct ReachableBound {
+    int score;
+    int gems;
+};
+
+// bound on the words below `node` that only counts the multipliers this path can still pick up: the word multiplier if
+// it has it or can still reach a double word, and letter multipliers on cells it can still reach. letter multipliers are
+// added up rather than assuming a single one, and the remaining length can't be longer than the reachable cells.
+// every letter left can pick up at most one gem, so the gems are capped the same way. a node none of whose words
+// fit in the reachable cells, or that need more letters missing from them than there are swaps left, has no bound at all:
+// it's pruned whatever the best word is, even before there is one
+template <typename Dict>
+static std::optional<ReachableBound> reachable_bound(const SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node) {
+    const SuffixBound suffix = ctx.dict.suffix(node, params);
+    // a short path can hardly wall anything off, all the unvisited cells are close enough and a lot cheaper
+    const BitBoard reach = params.word_len >= 4 ? reachable(params.cell, params.bboard) : ~params.bboard & FULL_BOARD;
+    const int max_len = std::min(suffix.max_len, std::popcount(reach));
+    // too few cells left to finish even the shortest word
+    if (max_len < suffix.min_len)
+        return std::nullopt;
+    // every letter the words need that no reachable cell has costs a swap
+    uint32_t letters = 0;
+    for (BitBoard cells = reach; cells; cells &= cells - 1)
+        letters |= ctx.masks.letters[std::countr_zero(cells)];
+    if (std::popcount(suffix.required_letters & ~letters) > params.swaps)
+        return std::nullopt;
+
+    const int triple_letters = std::min(std::popcount(ctx.masks.triple_letter & reach), max_len);
+    const int double_letters = std::min(std::popcount(ctx.masks.double_letter & reach), max_len - triple_letters);
+    const bool word_mul = params.has_word_mul || (ctx.masks.double_word & reach);
+
+    int upper_bound = params.current_word_points + suffix.letter_points;
+    upper_bound += suffix.max_letter_score * (triple_letters * 2 + double_letters);
+    upper_bound *= (word_mul ? 2 : 1);
+    upper_bound += (params.word_len + max_len >= 6 ? 10 : 0);
+
+    const int gems = params.current_eco_points + std::min(std::popcount(ctx.masks.gems & reach), max_len);
+    return ReachableBound{upper_bound, gems};
+}
+
+// what the search ranks words by, fixed for a whole search so every kernel is compiled for one of them
+enum class Objective {
+    // points
+    Score,
+    // gems, then points
+    Eco,
+    // the Frontier of points, gems and swaps spent
+    Pareto,
+    // a WeightedValue of points, gems and swaps spent
+    Weighted
+};
+
+// nothing below `node` can reach the best word found so far, `static_score` is ctx.dict.bound() of the node
+template <Objective O, typename Dict>
+static bool pruned(const SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node, int static_score) {
+    if (!ctx.finish_cells.empty() && !(ctx.finish_cells[node] & 1u << params.cell))
+        return true;
+
+    if constexpr (O == Objective::Score) {
+        const int max_score = ctx.best.score();
+        if (static_score < max_score)
+            return true;
+        const std::optional<ReachableBound> bound = reachable_bound(ctx, params, node);
+        return !bound || bound->score < max_score;
+    }
+
+    const int max_len = ctx.dict.suffix(node, params).max_len;
+    const int static_gems = params.current_eco_points + std::min(std::popcount(ctx.masks.gems & ~params.bboard), max_len);
+
+    if constexpr (O == Objective::Pareto) {
+        // the swaps spent so far are the fewest any word below can have spent
+        const int swaps_used = ctx.frontier->swaps_used(params);
+        if (ctx.frontier->dominates(static_score, static_gems, swaps_used))
+            return true;
+
+        const std::optional<ReachableBound> bound = reachable_bound(ctx, params, node);
+        return !bound || ctx.frontier->dominates(std::min(static_score, bound->score), bound->gems, swaps_used);
+    }
+
+    if constexpr (O == Objective::Weighted) {
+        const int64_t best_key = ctx.best.key();
+        if (ctx.weighted->bound(params, static_score, static_gems) < best_key)
+            return true;
+
+        const std::optional<ReachableBound> bound = reachable_bound(ctx, params, node);
+        return !bound || ctx.weighted->bound(params, std::min(static_score, bound->score), bound->gems) < best_key;
+    }
+
+    // eco mode ranks on gems first, so a subtree that can still pick up more gems than the best word has is worth
+    // searching whatever its points, and one that can't is never worth it. the packed keys compare exactly like that
+    const int64_t best_key = ctx.best.key();
+    if (ctx.best.pack(static_gems, static_score) < best_key)
+        return true;
+
+    const std::optional<ReachableBound> bound = reachable_bound(ctx, params, node);
+    return !bound || ctx.best.pack(bound->gems, std::min(static_score, bound->score)) < best_key;
+}
+
+template <Objective O, typename Dict>
+static bool pruned(const SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node) {
+    return pruned<O>(ctx, params, node, ctx.dict.bound(node, params));
+}
+
+// the points of the word the path spells
+static int word_score(const RecurseParams& params) {
+    return params.current_word_points * (params.has_word_mul ? 2 : 1) + (params.word_len >= 6 ? 10 : 0);
+}
+
+// what the word the path spells is ranked by, every objective but the pareto one
+template <Objective O, typename Dict>
+static int64_t word_key(const SearchContext<Dict>& ctx, const RecurseParams& params) {
+    if constexpr (O == Objective::Weighted)
+        return ctx.weighted->value(word_score(params), params.current_eco_points, ctx.weighted->swaps_used(params));
+    return ctx.best.pack(params.current_eco_points, word_score(params));
+}
+
+// record_word() would keep the word the path spells, for when its path still has to be worked out
+template <Objective O, typename Dict>
+static bool worth_recording(const SearchContext<Dict>& ctx, const RecurseParams& params) {
+    if constexpr (O == Objective::Pareto)
+        return !ctx.frontier->dominates(word_score(params), params.current_eco_points, ctx.frontier->swaps_used(params));
+    return word_key<O>(ctx, params) >= ctx.best.key();
+}
+
+// called once the path spells a whole word
+template <Objective O, typename Dict>
+static void record_word(SearchContext<Dict>& ctx, const RecurseParams& params) {
+    SearchResults& results = ctx.results;
+    const int eco_score = params.current_eco_points;
+    const int our_score = word_score(params);
+    const int64_t our_key = word_key<O>(ctx, params);
+
+    if constexpr (O == Objective::Pareto) {
+        ctx.frontier->add(our_score, eco_score, ctx.frontier->swaps_used(params), params.path);
+        return;
+    }
+    if (ctx.top) {
+        if (our_key >= ctx.best.key())
+            ctx.top->add(ctx.board, our_key, params.path, params.bboard);
+        return;
+    }
+
+    // another thread may have raised the bar since our last word, our ties are stale then
+    if (const int64_t best_key = ctx.best.key(); best_key > results.key) {
+        results.largest_word.clear();
+        results.key = best_key;
+    }
+
+    if (our_key > results.key) {
+        results.largest_word.clear();
+        results.largest_word.push_back(params.path);
+        results.key = our_key;
+        ctx.best.raise(our_key);
+    } else if (our_key == results.key) {
+        results.largest_word.push_back(params.path);
+    }
+}
+
+// whether a subtree should go to an idle thread instead of being searched right here
+template <typename Dict>
+static bool should_split(const SearchContext<Dict>& ctx, const RecurseParams& params) {
+    return ctx.pool && params.word_len <= TaskPool<SearchTask<Dict>>::max_split_depth && ctx.pool->hungry();
+}
+
+// recurse() is compiled for every objective and for 0 to max_static_swaps swaps left, where the swaps left are a
+// template argument and a kernel without swaps has no swap loop at all. dynamic_swaps reads params.swaps instead
+constexpr int max_static_swaps = 3;
+constexpr int dynamic_swaps = -1;
+
+// the kernel a child runs in once a swap is spent on it, the one without swaps never spends any
+constexpr int after_swap(int swaps) {
+    return swaps == dynamic_swaps ? dynamic_swaps : std::max(swaps - 1, 0);
+}
+
+// optimized implementation, hard to read, will refactor later
+template <Objective O, int Swaps, typename Dict>
+static void recurse(SearchContext<Dict>& ctx, const RecurseParams params, typename Dict::Node node);
+
+// either descends into the child right away or, when another thread is starving, hands it to the pool
+template <Objective O, int Swaps, typename Dict>
+static void descend(SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node) {
+    if (should_split(ctx, params)) [[unlikely]] {
+        ctx.pool->push(ctx.worker, {params, node});
+        return;
+    }
+    recurse<O, Swaps>(ctx, params, node);
+}
+
+// calls step(next_cell, letter index, swapped) for every child of the path: each free neighbor with every letter
+// swapped onto it first, then with its own letter
+template <int Swaps, typename Dict, typename Step>
+static void for_each_step(const SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node, Step&& step) {
+    const uint32_t bitfield = ctx.dict.children(node);
+    const bool can_swap = Swaps == dynamic_swaps ? params.swaps > 0 : Swaps > 0;
+
+    for (BitBoard neighbors = adjacency[params.cell] & ~params.bboard; neighbors; neighbors &= neighbors - 1) {
+        const int next_cell = std::countr_zero(neighbors);
+        const size_t reserved_index = char_to_index(std::get<0>(tile_at(ctx.board, next_cell)));
+
+        if (can_swap) {
+            for (size_t i = 0; i < N; ++i) {
+                if (!(bitfield & (1 << i)) || i == reserved_index)
+                    continue;
+                step(next_cell, i, true);
+            }
+        }
+
+        if (bitfield & (1 << reserved_index))
+            step(next_cell, reserved_index, false);
+    }
+}
+
+// params once the path steps onto `next_cell` with letter `index` on it
+template <typename Dict>
+static RecurseParams stepped(const SearchContext<Dict>& ctx, RecurseParams params, int next_cell, size_t index, bool swapped) {
+    const auto& [letter, tile_type, has_gem] = tile_at(ctx.board, next_cell);
+    params.update(next_cell, index + 'a', tile_type, has_gem, swapped);
+    return params;
+}
+
+// a child of the path and its static bound, for visiting the children best first
+struct Candidate {
+    int bound;
+    uint16_t rank;
+    uint8_t cell;
+    uint8_t index;
+    bool swapped;
+};
+
+template <Objective O, int Swaps, typename Dict>
+static void recurse(SearchContext<Dict>& ctx, const RecurseParams params, typename Dict::Node node) {
+    if (out_of_time(ctx) || pruned<O>(ctx, params, node))
+        return;
+
+    const auto step = [&](int next_cell, size_t index, bool swapped) {
+        const RecurseParams child_params = stepped(ctx, params, next_cell, index, swapped);
+        if (swapped)
+            descend<O, after_swap(Swaps)>(ctx, child_params, ctx.dict.child(node, index));
+        else
+            descend<O, Swaps>(ctx, child_params, ctx.dict.child(node, index));
+    };
+
+    if (ctx.order_children) {
+        // up to 8 neighbors with every letter on each
+        std::array<Candidate, 8 * N> candidates;
+        size_t count = 0;
+        for_each_step<Swaps>(ctx, params, node, [&](int next_cell, size_t index, bool swapped) {
+            const int bound = ctx.dict.bound(ctx.dict.child(node, index), stepped(ctx, params, next_cell, index, swapped));
+            candidates[count] = {bound, static_cast<uint16_t>(count), static_cast<uint8_t>(next_cell), static_cast<uint8_t>(index), swapped};
+            ++count;
+        });
+        // ties keep the unordered order
+        std::sort(candidates.begin(), candidates.begin() + count, [](const Candidate& a, const Candidate& b) {
+            return a.bound != b.bound ? a.bound > b.bound : a.rank < b.rank;
+        });
+        for (const Candidate& candidate : std::span(candidates.data(), count))
+            step(candidate.cell, candidate.index, candidate.swapped);
+    } else {
+        for_each_step<Swaps>(ctx, params, node, step);
+    }
+
+    if (ctx.dict.is_end(node))
+        record_word<O>(ctx, params);
+}
+
+// one level of iterative_search(): the state at a node plus how far its children have been tried
+template <typename Dict>
+struct SearchFrame {
+    RecurseParams params;
+    typename Dict::Node node;
+    // neighbors that haven't been stepped on yet
+    BitBoard neighbors;
+    // the neighbor being tried right now, and which letters are still to be put on it
+    int next_cell;
+    uint32_t swap_letters;
+    bool board_letter;
+};
+
+// same search as recurse(), in the same order, on a fixed stack instead of the call stack
+template <Objective O, typename Dict>
+static void iterative_search(SearchContext<Dict>& ctx, const RecurseParams params, typename Dict::Node node) {
+    if (pruned<O>(ctx, params, node))
+        return;
+
+    const Board& board = ctx.board;
+    std::array<SearchFrame<Dict>, 25> stack;
+    int top = 0;
+    stack[0] = {params, node, adjacency[params.cell] & ~params.bboard, 0, 0, false};
+
+    while (top >= 0) {
+        if (out_of_time(ctx))
+            return;
+        SearchFrame<Dict>& frame = stack[top];
+
+        // done with the letters for this neighbor, move on to the next one that has any
+        while (!frame.swap_letters && !frame.board_letter && frame.neighbors) {
+            frame.next_cell = std::countr_zero(frame.neighbors);
+            frame.neighbors &= frame.neighbors - 1;
+
+            const uint32_t bitfield = ctx.dict.children(frame.node);
+            const uint32_t reserved_bit = 1u << char_to_index(std::get<0>(tile_at(board, frame.next_cell)));
+            frame.swap_letters = frame.params.swaps > 0 ? bitfield & ~reserved_bit : 0;
+            frame.board_letter = bitfield & reserved_bit;
+        }
+
+        if (!frame.swap_letters && !frame.board_letter) {
+            if (ctx.dict.is_end(frame.node))
+                record_word<O>(ctx, frame.params);
+            top--;
+            continue;
+        }
+
+        // swapped letters go first, the letter actually on the tile last, like recurse() does
+        const auto& [letter, tile_type, has_gem] = tile_at(board, frame.next_cell);
+        RecurseParams child_params = frame.params;
+        size_t index;
+        if (frame.swap_letters) {
+            index = std::countr_zero(frame.swap_letters);
+            frame.swap_letters &= frame.swap_letters - 1;
+            child_params.update(frame.next_cell, index + 'a', tile_type, has_gem, true);
+        } else {
+            index = char_to_index(letter);
+            frame.board_letter = false;
+            child_params.update(frame.next_cell, letter, tile_type, has_gem, false);
+        }
+
+        const typename Dict::Node child = ctx.dict.child(frame.node, index);
+
+        if (should_split(ctx, child_params)) [[unlikely]] {
+            ctx.pool->push(ctx.worker, {child_params, child});
+            continue;
+        }
+        if (pruned<O>(ctx, child_params, child))
+            continue;
+
+        stack[++top] = {child_params, child, adjacency[frame.next_cell] & ~child_params.bboard, 0, 0, false};
+    }
+}
+
+// one depth of breadth_search() as a structure of arrays, so the passes over a whole level run down plain columns
+template <typename Dict>
+struct Level {
+    std::vector<typename Dict::Node> node;
+    std::vector<BitBoard> bboard;
+    std::vector<uint8_t> cell;
+    std::vector<int16_t> letter_points;
+    std::vector<int16_t> word_points;
+    std::vector<uint8_t> gems;
+    std::vector<uint8_t> swaps;
+    std::vector<uint8_t> word_mul;
+    // dict.bound() and dict.is_end() of the node, worked out as the state is pushed
+    std::vector<int> bound;
+    std::vector<uint8_t> end;
+
+    size_t size() const {
+        return node.size();
+    }
+
+    void clear() {
+        node.clear();
+        bboard.clear();
+        cell.clear();
+        letter_points.clear();
+        word_points.clear();
+        gems.clear();
+        swaps.clear();
+        word_mul.clear();
+        bound.clear();
+        end.clear();
+    }
+
+    void push(const RecurseParams& params, typename Dict::Node n, int static_bound, bool is_end) {
+        node.push_back(n);
+        bboard.push_back(params.bboard);
+        cell.push_back(params.cell);
+        letter_points.push_back(params.letter_points);
+        word_points.push_back(params.current_word_points);
+        gems.push_back(params.current_eco_points);
+        swaps.push_back(params.swaps);
+        word_mul.push_back(params.has_word_mul);
+        bound.push_back(static_bound);
+        end.push_back(is_end);
+    }
+
+    // without the path, breadth_search() only traces that back for the words it records
+    RecurseParams params(size_t i, int word_len) const {
+        return {PackedPath{}, bboard[i], cell[i], letter_points[i], word_points[i], gems[i], word_len, swaps[i], word_mul[i] != 0};
+    }
+};
+
+// how a state of breadth_search() got onto its level: which state of the level before stepped where with what letter
+struct BreadthStep {
+    uint32_t parent;
+    uint8_t cell;
+    uint8_t index;
+    bool swapped;
+};
+
+// the path of state `i` on the last level of `steps`, the root's path followed by every step that led to the state
+static PackedPath traced_path(const PackedPath& root, int root_len, std::span<const std::vector<BreadthStep>> steps, size_t i) {
+    std::array<BreadthStep, 25> trail;
+    for (size_t depth = steps.size(); depth-- > 0; i = trail[depth].parent)
+        trail[depth] = steps[depth][i];
+
+    PackedPath path = root;
+    for (size_t depth = 0; depth < steps.size(); ++depth)
+        path.push(root_len + depth, trail[depth].cell, trail[depth].index + 'a', trail[depth].swapped);
+    return path;
+}
+
+// adjacency[cell[i]] & ~bboard[i] for every state on a level, eight at a time with a gather from the table under AVX2
+static void free_neighbors(std::span<const uint8_t> cell, std::span<const BitBoard> bboard, std::span<BitBoard> free) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= cell.size(); i += 8) {
+        const __m256i cells = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cell.data() + i)));
+        const __m256i neighbors = _mm256_i32gather_epi32(reinterpret_cast<const int*>(adjacency.data()), cells, 4);
+        const __m256i taken = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bboard.data() + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(free.data() + i), _mm256_andnot_si256(taken, neighbors));
+    }
+#endif
+    for (; i < cell.size(); ++i)
+        free[i] = adjacency[cell[i]] & ~bboard[i];
+}
+
+// for every 8 bit mask the positions of its set bits, lowest first, a byte each
+constexpr static std::array<uint64_t, 256> make_set_bit_positions() {
+    std::array<uint64_t, 256> positions{};
+    for (int mask = 0; mask < 256; ++mask)
+        for (int bit = 0, found = 0; bit < 8; ++bit)
+            if (mask & 1 << bit)
+                positions[mask] |= static_cast<uint64_t>(bit) << (8 * found++);
+    return positions;
+}
+
+constexpr static std::array<uint64_t, 256> set_bit_positions = make_set_bit_positions();
+
+// writes the index of every state whose bound reaches `cutoff` and that can still step somewhere or ends a word to
+// `survivors`, in order, and returns how many there are. under AVX2 eight states are compared at once and the indices
+// of the ones kept are packed down through set_bit_positions, without a branch per state either way
+static size_t filter_survivors(std::span<const int> bounds, std::span<const BitBoard> free, std::span<const uint8_t> end, int cutoff, std::span<uint32_t> survivors) {
+    size_t kept = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i below = _mm256_set1_epi32(cutoff - 1);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 8 <= bounds.size(); i += 8) {
+        const __m256i bound = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds.data() + i));
+        const __m256i stuck = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(free.data() + i)), zero);
+        const __m256i ends = _mm256_cmpgt_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(end.data() + i))), zero);
+        const __m256i keep = _mm256_and_si256(_mm256_cmpgt_epi32(bound, below), _mm256_or_si256(_mm256_xor_si256(stuck, _mm256_set1_epi32(-1)), ends));
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(keep));
+
+        // kept <= i, so the eight indices written never go past the states compared so far
+        const __m256i positions = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(set_bit_positions[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(survivors.data() + kept), _mm256_add_epi32(positions, _mm256_set1_epi32(static_cast<int>(i))));
+        kept += std::popcount(static_cast<unsigned>(mask));
+    }
+#endif
+    for (; i < bounds.size(); ++i) {
+        survivors[kept] = i;
+        kept += (bounds[i] >= cutoff) & ((free[i] != 0) | end[i]);
+    }
+    return kept;
+}
+
+// the same search as recurse() a whole depth at a time. every state carries its static bound from when it was pushed,
+// and a child that already misses the bar isn't pushed at all. the free neighbors of every state on a level and
+// the filter that keeps the states whose bound still reaches the bar and that can still go somewhere run over whole
+// columns with free_neighbors() and filter_survivors(). only the states that are kept are turned back into
+// RecurseParams and go through the rest of pruned(). a state keeps no path, just a BreadthStep back to the one before
+// it, and the path is only traced back for a word record_word() keeps. those steps are kept for every level of the
+// task until it's done, so its memory grows with all the states it pushed, unlike the depth first engines that only
+// hold the current path. the pool hands out root tasks as usual
+template <Objective O, typename Dict>
+static void breadth_search(SearchContext<Dict>& ctx, const RecurseParams& params, typename Dict::Node node) {
+    Level<Dict> level;
+    Level<Dict> next;
+    std::vector<BitBoard> free;
+    std::vector<uint32_t> survivors;
+    // steps[d] has a BreadthStep for every state d + 1 letters past the root
+    std::vector<std::vector<BreadthStep>> steps;
+    level.push(params, node, ctx.dict.bound(node, params), ctx.dict.is_end(node));
+
+    // the static bound alone only settles it when words are ranked by points, every bound reaches -1
+    const auto bar = [&] { return O == Objective::Score ? ctx.best.score() : -1; };
+
+    for (int word_len = params.word_len; level.size() > 0; ++word_len) {
+        // the column passes count as a node per state
+        const size_t count = level.size();
+        if (out_of_time(ctx, count))
+            return;
+
+        free.resize(count);
+        survivors.resize(count);
+        free_neighbors(level.cell, level.bboard, free);
+        const size_t kept = filter_survivors(level.bound, free, level.end, bar(), survivors);
+
+        const size_t depth = word_len - params.word_len;
+        next.clear();
+        if (steps.size() <= depth)
+            steps.emplace_back();
+        steps[depth].clear();
+        for (size_t charged = 0; const uint32_t i : std::span(survivors.data(), kept)) {
+            // and so does every child pushed
+            if (out_of_time(ctx, next.size() - std::exchange(charged, next.size()) + 1))
+                return;
+
+            RecurseParams state = level.params(i, word_len);
+            if (pruned<O>(ctx, state, level.node[i], level.bound[i]))
+                continue;
+
+            // ranked by points the static bound weeds out most children for next to nothing, the others only have
+            // a bar pruned() can check, and it's cheaper than pushing a child the next level drops
+            const int cutoff = bar();
+            for_each_step<dynamic_swaps>(ctx, state, level.node[i], [&](int next_cell, size_t index, bool swapped) {
+                const typename Dict::Node child = ctx.dict.child(level.node[i], index);
+                const RecurseParams child_params = stepped(ctx, state, next_cell, index, swapped);
+                const int bound = ctx.dict.bound(child, child_params);
+                if (bound < cutoff || (O != Objective::Score && pruned<O>(ctx, child_params, child, bound)))
+                    return;
+                next.push(child_params, child, bound, ctx.dict.is_end(child));
+                steps[depth].push_back({i, static_cast<uint8_t>(next_cell), static_cast<uint8_t>(index), swapped});
+            });
+            if (level.end[i] && worth_recording<O>(ctx, state)) {
+                state.path = traced_path(params.path, params.word_len, std::span(steps.data(), depth), i);
+                record_word<O>(ctx, state);
+            }
+        }
+        std::swap(level, next);
+    }
+}
+
+// every start cell, and every start letter when swaps are allowed, in the order the serial search visits them
+template <typename Dict>
+static std::vector<SearchTask<Dict>> get_root_tasks(const Board& board, const Dict& dict, int swaps) {
+    std::vector<SearchTask<Dict>> tasks;
+    for (int i = 0; i < 5; ++i)
+        for (int j = 0; j < 5; ++j)
+            for (int a = 'a'; a <= 'z'; ++a) {
+                if (swaps == 0 && a != std::get<0>(board[i][j]))
+                    continue;
+                if (!(dict.children(dict.root) & 1 << (a - 'a'))) [[unlikely]]
+                    continue;
+
+                RecurseParams params{};
+                params.swaps = swaps;
+                params.update(i * 5 + j, a, std::get<1>(board[i][j]), std::get<2>(board[i][j]), a != std::get<0>(board[i][j]));
+
+                tasks.push_back({params, dict.child(dict.root, char_to_index(a))});
+            }
+    return tasks;
+}
+
+// the cells a path that spelled `node` can stand on and still go on to finish a word, letting it cross itself.
+// that is every cell on a word end, and otherwise the neighbors of the cells holding the next letter of a word
+template <typename Dict>
+static BitBoard finish_cells(const Dict& dict, const std::array<BitBoard, N>& letter_cells, typename Dict::Node node, std::vector<BitBoard>& memo) {
+    if (memo[node] != UINT32_MAX)
+        return memo[node];
+
+    BitBoard cells = dict.is_end(node) ? FULL_BOARD : 0;
+    for (uint32_t children = dict.children(node); children; children &= children - 1) {
+        const int index = std::countr_zero(children);
+        if (letter_cells[index])
+            cells |= neighbors(letter_cells[index] & finish_cells(dict, letter_cells, dict.child(node, index), memo));
+    }
+    return memo[node] = cells;
+}
+
+// finish_cells() of every node, for searches without swaps where every letter has to be on the board.
+// a DAWG node reached by several prefixes gets the cells of all of them, it only depends on what comes after it
+template <typename Dict>
+static std::vector<BitBoard> finish_cells_by_node(const Dict& dict, const BoardMasks& masks) {
+    std::array<BitBoard, N> letter_cells{};
+    for (int cell = 0; cell < 25; ++cell)
+        if (masks.letters[cell])
+            set(letter_cells[std::countr_zero(masks.letters[cell])], cell);
+
+    std::vector<BitBoard> memo(dict.size(), UINT32_MAX);
+    finish_cells(dict, letter_cells, dict.root, memo);
+    return memo;
+}
+
+enum class Engine {
+    Recursive,
+    Iterative,
+    Breadth
+};
+
+// picks the kernel for the task's swaps left, everything below it then knows them at compile time
+template <Objective O, typename Dict>
+static void search_task(SearchContext<Dict>& ctx, const SearchTask<Dict>& task, Engine engine) {
+    if (engine == Engine::Iterative)
+        return iterative_search<O>(ctx, task.params, task.node);
+    if (engine == Engine::Breadth)
+        return breadth_search<O>(ctx, task.params, task.node);
+
+    static_assert(max_static_swaps == 3);
+    switch (task.params.swaps) {
+        case 0:
+            return recurse<O, 0>(ctx, task.params, task.node);
+        case 1:
+            return recurse<O, 1>(ctx, task.params, task.node);
+        case 2:
+            return recurse<O, 2>(ctx, task.params, task.node);
+        case 3:
+            return recurse<O, 3>(ctx, task.params, task.node);
+        default:
+            return recurse<O, dynamic_swaps>(ctx, task.params, task.node);
+    }
+}
+
+// what to search for and how, everything besides the board and the dictionary
+struct SearchConfig {
+    int swaps = 0;
+    bool eco_mode = false;
+    unsigned threads = 1;
+    Engine engine = Engine::Recursive;
+    // only does anything without swaps
+    bool reach_prune = false;
+    // best bound first, for the start cells and the recursive engine's children
+    bool order_children = false;
+    // stop early when it runs out, null to search to the end
+    Deadline* deadline = nullptr;
+    // keep this many distinct words instead of just the best one and its ties, SharedBest then holds the worst of them
+    size_t top = 1;
+    // keep every word no other beats on points, gems and swaps spent at once, instead of ranking them
+    bool pareto = false;
+    // rank words by a WeightedValue instead of points or gems
+    std::optional<Weights> weights;
+    // go through deepening_search(), unless it's a pareto search
+    bool deepen = false;
+};
+
+// runs the search on `threads` threads, all of them pruning against the same SharedBest.
+// the root tasks are dealt out round robin and busy threads split their subtrees off for idle ones
+template <typename Dict>
+static std::vector<Path> parallel_search(const Board& board, const Dict& dict, const SearchConfig& config, SharedBest& best) {
+    std::vector<SearchTask<Dict>> tasks = get_root_tasks(board, dict, config.swaps);
+    if (config.order_children)
+        std::ranges::stable_sort(tasks, std::greater{}, [&](const SearchTask<Dict>& task) { return dict.bound(task.node, task.params); });
+    const unsigned threads = config.threads;
+    const BoardMasks masks(board);
+    const std::vector<BitBoard> finish_cells = config.reach_prune && config.swaps == 0 ? finish_cells_by_node(dict, masks) : std::vector<BitBoard>{};
+    std::vector<SearchResults> results(threads);
+    std::optional<TopWords> top;
+    if (config.top > 1)
+        top.emplace(config.top, best);
+    std::optional<Frontier> frontier;
+    if (config.pareto)
+        frontier.emplace(config.swaps);
+
+    std::optional<WeightedValue> weighted;
+    if (config.weights)
+        weighted.emplace(*config.weights, config.swaps);
+
+    Objective objective = config.eco_mode ? Objective::Eco : Objective::Score;
+    if (config.pareto)
+        objective = Objective::Pareto;
+    else if (config.weights)
+        objective = Objective::Weighted;
+    const auto search = [&](SearchContext<Dict>& ctx, SearchTask<Dict>& task) {
+        switch (objective) {
+            case Objective::Score:
+                return search_task<Objective::Score>(ctx, task, config.engine);
+            case Objective::Eco:
+                return search_task<Objective::Eco>(ctx, task, config.engine);
+            case Objective::Pareto:
+                return search_task<Objective::Pareto>(ctx, task, config.engine);
+            case Objective::Weighted:
+                return search_task<Objective::Weighted>(ctx, task, config.engine);
+        }
+    };
+
+    if (threads == 1) {
+        SearchContext<Dict> ctx{board, masks, finish_cells, dict, best, results[0], config.order_children, nullptr, 0, config.deadline, top ? &*top : nullptr, frontier ? &*frontier : nullptr, weighted ? &*weighted : nullptr};
+        for (SearchTask<Dict>& task : tasks)
+            search(ctx, task);
+    } else {
+        TaskPool<SearchTask<Dict>> pool(threads);
+        // pushed in reverse so each owner pops its share in board order
+        for (size_t i = tasks.size(); i-- > 0;)
+            pool.push(i % threads, std::move(tasks[i]));
+
+        std::vector<std::jthread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                SearchContext<Dict> ctx{board, masks, finish_cells, dict, best, results[t], config.order_children, &pool, t, config.deadline, top ? &*top : nullptr, frontier ? &*frontier : nullptr, weighted ? &*weighted : nullptr};
+                pool.work(t, [&](SearchTask<Dict>& task) { search(ctx, task); });
+            });
+    }
+
+    if (frontier)
+        return frontier->sorted(board);
+    if (top)
+        return top->sorted(board);
+
+    std::vector<Path> largest_word;
+    for (auto& result : results)
+        if (result.key == best.key())
+            for (const PackedPath& path : result.largest_word)
+                largest_word.push_back(path.unpack(board));
+
+    // every tie is found, but which thread found which is down to timing, sort so the output doesn't depend on it
+    std::ranges::sort(largest_word);
+
+    return largest_word;
+}
+
+// solves with no swaps first, then one, and so on up to config.swaps. the best word of a budget is still there with one
+// more swap, so each stage starts at it instead of at 0, ties with it still get through
+template <typename Dict>
+static std::vector<Path> deepening_search(const Board& board, const Dict& dict, SearchConfig config, SharedBest& best) {
+    const int swaps = config.swaps;
+    std::vector<Path> words;
+    int64_t key = 0;
+    for (config.swaps = 0; config.swaps <= swaps; ++config.swaps) {
+        SharedBest stage_best(config.eco_mode);
+        stage_best.raise(key);
+        std::vector<Path> stage_words = parallel_search(board, dict, config, stage_best);
+
+        // a stage the deadline cut short may not have got back to the words of the one before, its key is no help since
+        // it starts at theirs. it only takes over once it recorded a word, or as many as before with --top
+        const bool cut_short = config.deadline && config.deadline->expired();
+        if (!cut_short || stage_words.size() >= std::max<size_t>(1, std::min(words.size(), config.top))) {
+            words = std::move(stage_words);
+            key = stage_best.key();
+        }
+        if (cut_short)
+            break;
+    }
+
+    best.raise(key);
+    return words;
+}
+
+// default word, should be overridden by recurse, also should be refactored out
+
+// five lines of five tiles, a letter followed by its modifiers, like board.txt
+static Board parse_board(std::istream& board_file) {
+    Board board{};
+    int i = 0;
+
+    for (std::string line; std::getline(board_file, line);) {
+        auto letters = std::views::split(line, ' ');
+        auto v = std::views::zip(letters, std::views::iota(0)) | std::views::take(5);
+
+        for (auto [letter, e] : v) {
+            TileType tile_type = TileType::Normal;
+            bool has_gem = false;
+            for (size_t c = 1; c < letter.size(); ++c) {
+                if (!std::isalpha(letter[c]))
+                    continue;
+                switch (letter[c]) {
+                    case 'l':
+                        tile_type = TileType::DoubleLetter;
+                        break;
+                    case 't':
+                        tile_type = TileType::TripleLetter;
+                        break;
+                    case 'w':
+                        tile_type = TileType::DoubleWord;
+                        break;
+                    case 'i':
+                        tile_type = TileType::Ice;
+                        break;
+                    case 'g':
+                        has_gem = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            board[i][e] = {letter[0], tile_type, has_gem};
+        }
+        i++;
+    }
+
+    return board;
+}
+
+// a board a --serve client sent, which unlike board.txt can't be trusted to have five rows of five tiles that
+// start with a letter from a to z, anything else would be written past the board or index past the letter tables
+static Board parse_request_board(const std::string& text) {
+    std::istringstream rows(text);
+    int row_count = 0;
+    for (std::string row; std::getline(rows, row); ++row_count) {
+        if (row_count == 5)
+            throw std::runtime_error("board has more than 5 rows");
+        int tile_count = 0;
+        for (const auto tile : std::views::split(row, ' ')) {
+            if (tile.empty() || tile.front() < 'a' || tile.front() > 'z')
+                throw std::runtime_error(std::format("tile {} of board row {} doesn't start with a letter from a to z", tile_count + 1, row_count + 1));
+            ++tile_count;
+        }
+        if (tile_count != 5)
+            throw std::runtime_error(std::format("board row {} has {} tiles instead of 5", row_count + 1, tile_count));
+    }
+    if (row_count != 5)
+        throw std::runtime_error(std::format("board has {} rows instead of 5", row_count));
+
+    std::istringstream board_stream(text);
+    return parse_board(board_stream);
+}
+
+static Board parse_board_from_file() {
+    std::ifstream board_file("board.txt");
+    return parse_board(board_file);
+}
+
+static void print_biggest_word(const Board& board, std::vector<Path>& biggest_words, size_t count) {
+    for (auto& words : std::views::reverse(biggest_words) | std::views::take(count)) {
+        std::cout << "board: " << std::endl;
+        for (int i = 0; i < 5; ++i) {
+            for (int j = 0; j < 5; j++) {
+                auto it = std::ranges::find_if(words, [i, j](const auto& path) {
+                    auto [x, y, c] = path;
+                    return x == i && y == j;
+                });
+                const char c = std::get<0>(board[i][j]);
+
+                if (it != words.end()) {
+                    {
+                        char it_c = std::get<2>(*it);
+                        bool first = it == words.begin();
+                        if (it_c != c)
+                        // make the brackets red
+                        {
+                            std::cout << std::format("\033[1;31m[\033[0m");
+
+                            if (first)
+                                // color this green
+                                std::cout << std::format("\033[1;32m{}\033[0m", it_c);
+                            else
+                                std::cout << std::format("\033[1;31m{}\033[0m", it_c);
+
+                            std::cout << std::format("\033[1;31m]\033[0m");
+                        } else
+                            // make the text white
+                            if (first)
+                                // color this green
+                                std::cout << std::format("\033[1;32m[{}]\033[0m", it_c);
+                            else
+                                std::cout << std::format("\033[1;37m[{}]\033[0m", it_c);
+                    }
+                } else
+                    std::cout << std::format(" {} ", c);
+            }
+            std::cout << std::endl;
+            std::cout << std::endl;
+        }
+        std::cout << "word found: ";
+        for (auto [x, y, c] : words)
+            std::cout << c;
+        std::cout << std::endl;
+
+        for (auto [x, y, c] : words)
+            std::cout << std::format("({}, {}, {}), ", x, y, c);
+        std::cout << std::endl;
+
+        std::cout << "score: " << score(board, words) << std::endl;
+        std::cout << std::endl;
+    }
+}
+
+// how many times each letter shows up, padded to 32 so a histogram is exactly two SSE registers
+using LetterHistogram = std::array<uint8_t, 32>;
+
+static LetterHistogram board_histogram(const Board& board) {
+    LetterHistogram histogram{};
+    for (auto& row : board)
+        for (auto& [letter, tile_type, has_gem] : row)
+            if (size_t index = char_to_index(letter); index < N)
+                histogram[index]++;
+    return histogram;
+}
+
+static LetterHistogram word_histogram(const std::string_view word) {
+    LetterHistogram histogram{};
+    for (const char c : word)
+        if (size_t index = char_to_index(c); index < N)
+            histogram[index] = std::min(histogram[index] + 1, 255);
+    return histogram;
+}
+
+// letters the word needs more of than the board has, every one of them has to be swapped in
+static int missing_letters(const LetterHistogram& word, const LetterHistogram& board) {
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i missing = zero;
+    for (size_t i = 0; i < word.size(); i += 16) {
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(word.data() + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(board.data() + i));
+        // saturating subtract clamps the letters the board has enough of to 0, sad sums the rest
+        missing = _mm_add_epi64(missing, _mm_sad_epu8(_mm_subs_epu8(w, b), zero));
+    }
+    return _mm_cvtsi128_si32(missing) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(missing, missing));
+#else
+    int missing = 0;
+    for (size_t i = 0; i < word.size(); ++i)
+        missing += std::max(word[i] - board[i], 0);
+    return missing;
+#endif
+}
+
+// the word can't be on the board, not even after spending every swap
+static bool impossible_word(const std::string_view word, const LetterHistogram& board, int swaps) {
+    return word.size() > 25 || missing_letters(word_histogram(word), board) > swaps;
+}
+
+static std::pair<bool, TileType> get_mods(const Board& board) {
+    TileType max_letter_mod = TileType::Normal;
+    bool has_word_mod = false;
+    for (auto& row : board)
+        for (auto& [letter, tile_type, has_gem] : row)
+            if (tile_type == TileType::DoubleLetter)
+                max_letter_mod = max_letter_mod == TileType::Normal ? TileType::DoubleLetter : max_letter_mod;
+            else if (tile_type == TileType::TripleLetter)
+                max_letter_mod = TileType::TripleLetter;
+            else if (tile_type == TileType::DoubleWord)
+                has_word_mod = true;
+
+    return {has_word_mod, max_letter_mod};
+}
+
+// what a search found, the words in the order parallel_search() returns them
+struct Solution {
+    std::vector<Path> words;
+    int max_score = 0;
+    int max_eco_score = 0;
+};
+
+// whichever of the dictionaries got loaded, nothing in it is written to by a search so any number can share it
+struct Dictionary {
+    const Trie& trie;
+    const std::optional<Dawg>& dawg;
+
+    Solution solve(const Board& board, const SearchConfig& config) const {
+        const auto [has_word_mod, max_letter_mod] = get_mods(board);
+        SharedBest best(config.eco_mode);
+        const auto run = [&](const auto& dict) {
+            // the frontier has no single best key to hand from one stage to the next, deepening would just search it
+            // once per budget and keep the last
+            const bool deepen = config.deepen && !config.pareto;
+            return deepen ? deepening_search(board, dict, config, best) : parallel_search(board, dict, config, best);
+        };
+
+        Solution solution;
+        solution.words = dawg ? run(DawgDict{*dawg, dawg->root, has_word_mod, max_letter_mod})
+                              : run(TrieDict{trie, Trie::root, mod_profile(has_word_mod, max_letter_mod)});
+        if (solution.words.empty())
+            return solution;
+
+        if (config.top > 1 || config.pareto) {
+            // SharedBest ends up at the worst of the top words or isn't used at all, the best one is last
+            solution.max_score = score(board, solution.words.back());
+            solution.max_eco_score = gems(board, solution.words.back());
+        } else if (config.weights) {
+            // SharedBest holds the weighted value, the points and gems are the best word's own
+            solution.max_score = score(board, solution.words.front());
+            solution.max_eco_score = gems(board, solution.words.front());
+        } else {
+            solution.max_score = best.score();
+            solution.max_eco_score = config.eco_mode ? best.key() >> 16 : gems(board, solution.words.front());
+        }
+        return solution;
+    }
+};
+
+struct Options {
+    // 0 means one per hardware thread
+    unsigned threads = 1;
+    // search a minimized DAWG instead of the trie
+    bool dawg = false;
+    // write the DAWG to wordlist.dawg, later runs map it instead of reading wordlist.txt
+    bool compile = false;
+    Engine engine = Engine::Recursive;
+    // skip the words the board can't possibly finish before searching, only without swaps
+    bool reach_prune = false;
+    // try the most promising start cells and letters first
+    bool order = false;
+    // solve with fewer swaps first to start the full search with a cutoff
+    bool deepen = false;
+    // stop searching after this long and report the best word so far, 0 for no limit
+    std::chrono::milliseconds deadline{0};
+    // report the best this many words, 1 for the best one and its ties
+    size_t top = 1;
+    // report every trade-off between points, gems and swaps spent instead of the single best word
+    bool pareto = false;
+    // rank words by points + gem weight * gems - swap weight * swaps spent
+    std::optional<Weights> weights;
+    // time every engine on the board instead of printing words
+    bool bench = false;
+    // answer requests on this unix socket, or on stdin with "-", instead of solving board.txt
+    std::string serve;
+};
+
+static Options parse_options(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::stoi(argv[++i]);
+        else if (arg == "--dawg")
+            options.dawg = true;
+        else if (arg == "--compile")
+            options.compile = true;
+        else if (arg == "--reach-prune")
+            options.reach_prune = true;
+        else if (arg == "--order")
+            options.order = true;
+        else if (arg == "--deepen")
+            options.deepen = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc)
+            options.deadline = std::chrono::milliseconds(std::stoi(argv[++i]));
+        else if (arg == "--top" && i + 1 < argc)
+            options.top = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--pareto")
+            options.pareto = true;
+        else if (arg == "--weights" && i + 1 < argc) {
+            // gem weight and swap weight, comma separated
+            const std::string_view weights = argv[++i];
+            const size_t comma = weights.find(',');
+            if (comma == std::string_view::npos)
+                throw std::runtime_error(std::format("expected --weights GEM,SWAP, got {}", weights));
+            options.weights = checked_weights(std::stod(std::string(weights.substr(0, comma))), std::stod(std::string(weights.substr(comma + 1))));
+        }
+        else if (arg == "--engine" && i + 1 < argc && argv[i + 1] == std::string_view("recursive"))
+            options.engine = Engine::Recursive, ++i;
+        else if (arg == "--engine" && i + 1 < argc && argv[i + 1] == std::string_view("iterative"))
+            options.engine = Engine::Iterative, ++i;
+        else if (arg == "--engine" && i + 1 < argc && argv[i + 1] == std::string_view("breadth"))
+            options.engine = Engine::Breadth, ++i;
+        else if (arg == "--bench")
+            options.bench = true;
+        else if (arg == "--serve" && i + 1 < argc)
+            options.serve = argv[++i];
+        else
+            throw std::runtime_error(std::format("unknown argument: {}", arg));
+    }
+
+    if (options.threads == 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    return options;
+}
+
+// just enough JSON for the --serve requests: objects, arrays, strings, numbers, true, false and null
+struct Json {
+    std::variant<std::nullptr_t, bool, double, std::string, std::vector<Json>, std::vector<std::pair<std::string, Json>>> value;
+
+    // null when it's not an object or has no such member
+    const Json* find(std::string_view key) const {
+        if (const auto* members = std::get_if<std::vector<std::pair<std::string, Json>>>(&value))
+            for (const auto& [name, member] : *members)
+                if (name == key)
+                    return &member;
+        return nullptr;
+    }
+
+    template <typename T>
+    const T& as(std::string_view what) const {
+        if (const T* v = std::get_if<T>(&value))
+            return *v;
+        throw std::runtime_error(std::format("{} has the wrong type", what));
+    }
+
+    static Json parse(std::string_view text) {
+        size_t pos = 0;
+        Json json = parse_value(text, pos, 0);
+        skip_space(text, pos);
+        if (pos != text.size())
+            throw std::runtime_error(std::format("unexpected {} at {}", text[pos], pos));
+        return json;
+    }
+
+   private:
+    // requests are two levels deep, this only keeps a hostile one from running the parser off the stack
+    static constexpr int max_depth = 32;
+
+    static void skip_space(std::string_view text, size_t& pos) {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+            ++pos;
+    }
+
+    static void expect(std::string_view text, size_t& pos, char c) {
+        skip_space(text, pos);
+        if (pos >= text.size() || text[pos] != c)
+            throw std::runtime_error(std::format("expected {} at {}", c, pos));
+        ++pos;
+    }
+
+    static std::string parse_string(std::string_view text, size_t& pos) {
+        expect(text, pos, '"');
+        std::string string;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\' && pos < text.size()) {
+                switch (c = text[pos++]) {
+                    case 'n':
+                        c = '\n';
+                        break;
+                    case 't':
+                        c = '\t';
+                        break;
+                    case 'r':
+                        c = '\r';
+                        break;
+                    case 'b':
+                        c = '\b';
+                        break;
+                    case 'f':
+                        c = '\f';
+                        break;
+                    case '"':
+                    case '\\':
+                    case '/':
+                        break;
+                    case 'u': {
+                        // only ASCII is ever needed here, and never a NUL
+                        const std::string_view hex = text.substr(pos, 4);
+                        unsigned code = 0;
+                        const auto [end, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), code, 16);
+                        if (hex.size() != 4 || ec != std::errc{} || end != hex.data() + hex.size() || code == 0 || code > 0x7f)
+                            throw std::runtime_error(std::format("bad \\u escape at {}, only \\u0001 to \\u007f are allowed", pos - 2));
+                        c = static_cast<char>(code);
+                        pos += 4;
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error(std::format("unknown escape \\{} at {}", c, pos - 2));
+                }
+            }
+            string += c;
+        }
+        expect(text, pos, '"');
+        return string;
+    }
+
+    static Json parse_value(std::string_view text, size_t& pos, int depth) {
+        skip_space(text, pos);
+        if (pos >= text.size())
+            throw std::runtime_error("unexpected end of input");
+        if (depth > max_depth)
+            throw std::runtime_error(std::format("nested deeper than {} at {}", max_depth, pos));
+
+        const char c = text[pos];
+        if (c == '"')
+            return {parse_string(text, pos)};
+        if (c == '[') {
+            std::vector<Json> array;
+            ++pos;
+            skip_space(text, pos);
+            if (pos < text.size() && text[pos] == ']')
+                return ++pos, Json{std::move(array)};
+            do
+                array.push_back(parse_value(text, pos, depth + 1));
+            while (skip_space(text, pos), pos < text.size() && text[pos] == ',' && ++pos);
+            expect(text, pos, ']');
+            return {std::move(array)};
+        }
+        if (c == '{') {
+            std::vector<std::pair<std::string, Json>> members;
+            ++pos;
+            skip_space(text, pos);
+            if (pos < text.size() && text[pos] == '}')
+                return ++pos, Json{std::move(members)};
+            do {
+                std::string name = parse_string(text, pos);
+                expect(text, pos, ':');
+                members.emplace_back(std::move(name), parse_value(text, pos, depth + 1));
+            } while (skip_space(text, pos), pos < text.size() && text[pos] == ',' && ++pos);
+            expect(text, pos, '}');
+            return {std::move(members)};
+        }
+        for (const auto& [word, json] : {std::pair{"true", Json{true}}, {"false", Json{false}}, {"null", Json{nullptr}}})
+            if (text.substr(pos).starts_with(word))
+                return pos += std::string_view(word).size(), json;
+
+        return {parse_number(text, pos)};
+    }
+
+    // only what the JSON grammar allows, strtod would also take nan, inf, hex and a leading +
+    static double parse_number(std::string_view text, size_t& pos) {
+        const size_t start = pos;
+        const auto digits = [&] {
+            const size_t first = pos;
+            while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])))
+                ++pos;
+            return pos > first;
+        };
+        if (pos < text.size() && text[pos] == '-')
+            ++pos;
+        const bool leading_zero = pos < text.size() && text[pos] == '0';
+        bool valid = digits() && !(leading_zero && pos - start > (text[start] == '-' ? 2 : 1));
+        if (valid && pos < text.size() && text[pos] == '.')
+            valid = (++pos, digits());
+        if (valid && pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            if (++pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+                ++pos;
+            valid = digits();
+        }
+
+        double number = 0;
+        if (!valid || std::from_chars(text.data() + start, text.data() + pos, number).ec != std::errc{})
+            throw std::runtime_error(std::format("bad number at {}", start));
+        return number;
+    }
+};
+
+static std::string json_string(std::string_view string) {
+    std::string quoted = "\"";
+    for (const char c : string) {
+        if (c == '"' || c == '\\')
+            quoted += {'\\', c};
+        else if (static_cast<unsigned char>(c) < 0x20)
+            quoted += std::format("\\u{:04x}", static_cast<int>(c));
+        else
+            quoted += c;
+    }
+    return quoted + '"';
+}
+
+// the most words a --serve request can ask for with "top"
+constexpr size_t max_top_words = 100;
+
+// one --serve request, everything but "board" can be left out:
+// {"id": "turn-3", "board": "a b c d e\n...", "swaps": 2, "eco": false, "top": 1, "pareto": false, "deadline_ms": 0, "weights": [8, 5]}
+// the board is the text of a board.txt, or its five lines as an array. the reply is one line as well, with the id
+// echoed back since replies go out in the order they finish. a request that can't be answered gets an "error"
+static std::string answer(const Dictionary& dictionary, const Options& options, std::string_view line) {
+    std::string id = "null";
+    try {
+        const Json request = Json::parse(line);
+        if (const Json* request_id = request.find("id"))
+            id = std::holds_alternative<double>(request_id->value) ? std::format("{}", request_id->as<double>("id")) : json_string(request_id->as<std::string>("id"));
+
+        const Json* board_json = request.find("board");
+        if (!board_json)
+            throw std::runtime_error("no board");
+        std::string board_text;
+        if (const auto* rows = std::get_if<std::vector<Json>>(&board_json->value))
+            for (const Json& row : *rows)
+                board_text += row.as<std::string>("board row") + '\n';
+        else
+            board_text = board_json->as<std::string>("board");
+        const Board board = parse_request_board(board_text);
+
+        // a whole number from `min` to `max`, checked before it's converted since any double is valid JSON
+        const auto integer = [&](std::string_view key, int64_t fallback, int64_t min, int64_t max) {
+            const Json* json = request.find(key);
+            if (!json)
+                return fallback;
+            const double value = json->as<double>(key);
+            if (!(value >= min && value <= max) || value != std::floor(value))
+                throw std::runtime_error(std::format("{} has to be a whole number from {} to {}", key, min, max));
+            return static_cast<int64_t>(value);
+        };
+        const int swaps = integer("swaps", 0, 0, PackedPath::max_swaps);
+
+        SearchConfig config{swaps, false, options.threads, options.engine, options.reach_prune, options.order, nullptr, options.top, options.pareto, options.weights, options.deepen};
+        if (const Json* eco = request.find("eco"))
+            config.eco_mode = eco->as<bool>("eco");
+        // every one of them is kept in memory and sent back, so a client only gets so many
+        config.top = std::clamp<int64_t>(integer("top", std::min(config.top, max_top_words), 0, INT32_MAX), 1, max_top_words);
+        if (const Json* pareto = request.find("pareto"))
+            config.pareto = pareto->as<bool>("pareto");
+        if (const Json* weights = request.find("weights")) {
+            const auto& pair = weights->as<std::vector<Json>>("weights");
+            if (pair.size() != 2)
+                throw std::runtime_error("weights needs a gem and a swap weight");
+            config.weights = checked_weights(pair[0].as<double>("gem weight"), pair[1].as<double>("swap weight"));
+        }
+        std::optional<Deadline> deadline;
+        if (const int64_t deadline_ms = integer("deadline_ms", options.deadline.count(), 0, INT32_MAX); deadline_ms > 0)
+            config.deadline = &deadline.emplace(std::chrono::milliseconds(deadline_ms));
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        const Solution solution = dictionary.solve(board, config);
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::string words;
+        for (const Path& path : std::views::reverse(solution.words) | std::views::take(config.pareto ? solution.words.size() : std::max<size_t>(config.top, 10))) {
+            std::string word;
+            std::string cells;
+            for (auto [x, y, c] : path) {
+                word += c;
+                cells += std::format("{}[{},{}]", cells.empty() ? "" : ",", x, y);
+            }
+            words += std::format("{}{{\"word\":{},\"score\":{},\"gems\":{},\"path\":[{}]}}", words.empty() ? "" : ",", json_string(word), score(board, path), gems(board, path), cells);
+        }
+        return std::format("{{\"id\":{},\"max_score\":{},\"max_eco_score\":{},\"optimal\":{},\"elapsed_ms\":{},\"words\":[{}]}}", id, solution.max_score, solution.max_eco_score,
+                           deadline && deadline->expired() ? "false" : "true", std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000., words);
+    } catch (const std::exception& e) {
+        return std::format("{{\"id\":{},\"error\":{}}}", id, json_string(e.what()));
+    }
+}
+
+// where the replies to one connection's requests go. every request holds on to it, so a socket stays open until the
+// last of them is answered even if the client stopped sending long before. once a reply can't be written the channel
+// is closed for good, the rest of them are dropped and the connection's reader sees the end of its input
+class ReplyChannel {
+   public:
+    // `owned` closes `fd` along with the channel
+    ReplyChannel(int fd, bool owned) : fd(fd), owned(owned) {}
+    ReplyChannel(const ReplyChannel&) = delete;
+    ReplyChannel& operator=(const ReplyChannel&) = delete;
+
+    ~ReplyChannel() {
+        if (owned)
+            close(fd);
+    }
+
+    // writes one whole reply. a client that went away (EPIPE, SIGPIPE is ignored while serving) or doesn't read its
+    // replies (a socket's writes time out after reply_timeout) closes the channel, half a reply can't be taken back
+    void send(const std::string& reply) {
+        std::lock_guard lock(mutex);
+        for (size_t written = 0; written < reply.size() && is_open();) {
+            const ssize_t w = write(fd, reply.data() + written, reply.size() - written);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0) {
+                open = false;
+                shutdown(fd, SHUT_RDWR);
+                return;
+            }
+            written += w;
+        }
+    }
+
+    bool is_open() const {
+        return open.load(std::memory_order_relaxed);
+    }
+
+   private:
+    int fd;
+    bool owned;
+    std::mutex mutex;
+    std::atomic<bool> open = true;
+};
+
+// answers requests from every connection on a fixed set of threads. at most `capacity` requests wait in line, a reader
+// that gets further ahead than that blocks until one is taken, so no more than threads + capacity are ever in flight
+class RequestPool {
+   public:
+    struct Request {
+        std::string line;
+        std::shared_ptr<ReplyChannel> reply;
+    };
+
+    RequestPool(const Dictionary& dictionary, const Options& options, unsigned threads, size_t capacity)
+        : dictionary(dictionary), options(options), capacity(capacity) {
+        for (unsigned t = 0; t < threads; ++t)
+            workers.emplace_back([this] { work(); });
+    }
+
+    // the workers answer whatever is still queued, then the jthreads join them
+    ~RequestPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        not_empty.notify_all();
+    }
+
+    void submit(Request request) {
+        {
+            std::unique_lock lock(mutex);
+            not_full.wait(lock, [&] { return queue.size() < capacity; });
+            queue.push_back(std::move(request));
+        }
+        not_empty.notify_one();
+    }
+
+   private:
+    void work() {
+        for (;;) {
+            Request request;
+            {
+                std::unique_lock lock(mutex);
+                not_empty.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                request = std::move(queue.front());
+                queue.pop_front();
+            }
+            not_full.notify_one();
+            // nobody is going to read the reply
+            if (!request.reply->is_open())
+                continue;
+            request.reply->send(answer(dictionary, options, request.line) + '\n');
+        }
+    }
+
+    const Dictionary& dictionary;
+    const Options& options;
+    size_t capacity;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<Request> queue;
+    bool stopping = false;
+    // last, so they're joined before anything they use goes away
+    std::vector<std::jthread> workers;
+};
+
+// the longest request line, the rest of a longer one is skipped up to the next newline
+constexpr size_t max_request_length = 64 * 1024;
+
+// hands every line read from `in` to the pool, the replies go out through `reply` as they finish
+static void serve_connection(RequestPool& pool, int in, const std::shared_ptr<ReplyChannel>& reply) {
+    const std::string too_long = std::format("{{\"id\":null,\"error\":\"request longer than {} bytes\"}}\n", max_request_length);
+    std::string buffer;
+    // the end of a line that was already refused for being too long is still to come
+    bool skipping = false;
+    std::array<char, 4096> chunk;
+    for (ssize_t n; (n = read(in, chunk.data(), chunk.size())) != 0;) {
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        buffer.append(chunk.data(), n);
+        for (size_t end; (end = buffer.find('\n')) != std::string::npos; buffer.erase(0, end + 1)) {
+            if (std::exchange(skipping, false))
+                continue;
+            if (end > max_request_length) {
+                reply->send(too_long);
+                continue;
+            }
+            std::string line = buffer.substr(0, end);
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            pool.submit({std::move(line), reply});
+        }
+        if (buffer.size() > max_request_length) {
+            if (!std::exchange(skipping, true))
+                reply->send(too_long);
+            buffer.clear();
+        }
+    }
+}
+
+// a connection's reader thread, `done` is set once it stops reading so the accept loop can join it
+struct Connection {
+    std::jthread reader;
+    std::atomic<bool> done = false;
+};
+
+// requests waiting for a thread, on top of the ones being answered
+constexpr size_t max_queued_requests = 64;
+// connections past this are told so and closed straight away
+constexpr size_t max_connections = 64;
+// a client that hasn't taken a reply off its socket in this long is disconnected
+constexpr timeval reply_timeout{5, 0};
+// how long to wait before accepting again after running out of file descriptors or memory
+constexpr std::chrono::milliseconds accept_backoff{100};
+
+// requests come in on stdin with "-", otherwise on a unix socket at `path` where every connection gets a reader of its
+// own. either way they're answered by one RequestPool with as many requests at a time as options.threads fits in the cores
+static void serve(const Dictionary& dictionary, const Options& options, const std::string& path) {
+    // a client that hangs up before its reply would otherwise kill the whole daemon
+    std::signal(SIGPIPE, SIG_IGN);
+    RequestPool pool(dictionary, options, std::max(1u, std::thread::hardware_concurrency() / options.threads), max_queued_requests);
+
+    if (path == "-")
+        return serve_connection(pool, STDIN_FILENO, std::make_shared<ReplyChannel>(STDOUT_FILENO, false));
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error(std::format("socket path too long: {}", path));
+    path.copy(address.sun_path, path.size());
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+        throw std::runtime_error("can't create a socket");
+    // only a socket an earlier run left behind is replaced, anything else at `path` is left alone
+    if (struct stat existing{}; lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            close(server);
+            throw std::runtime_error(std::format("{} exists and isn't a socket", path));
+        }
+        unlink(path.c_str());
+    }
+    if (bind(server, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 16) != 0) {
+        close(server);
+        throw std::runtime_error(std::format("can't listen on {}", path));
+    }
+    std::cerr << std::format("serving on {}", path) << std::endl;
+
+    std::list<Connection> connections;
+    // logged once until an accept goes through again
+    bool accept_failing = false;
+    for (;;) {
+        const int connection = accept(server, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR)
+                continue;
+            // out of file descriptors or memory, or a client that hung up while still queued, none of them is for good
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM || errno == ECONNABORTED) {
+                if (!std::exchange(accept_failing, true))
+                    std::cerr << std::format("can't accept on {}: {}, retrying", path, std::strerror(errno)) << std::endl;
+                connections.remove_if([](const Connection& c) { return c.done.load(); });
+                std::this_thread::sleep_for(accept_backoff);
+                continue;
+            }
+            throw std::runtime_error(std::format("can't accept on {}: {}", path, std::strerror(errno)));
+        }
+        accept_failing = false;
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &reply_timeout, sizeof(reply_timeout));
+
+        connections.remove_if([](const Connection& c) { return c.done.load(); });
+        if (connections.size() >= max_connections) {
+            ReplyChannel(connection, true).send("{\"id\":null,\"error\":\"too many connections\"}\n");
+            continue;
+        }
+
+        Connection& c = connections.emplace_back();
+        c.reader = std::jthread([&pool, &c, connection, reply = std::make_shared<ReplyChannel>(connection, true)] {
+            serve_connection(pool, connection, reply);
+            c.done = true;
+        });
+    }
+}
+
+// reads wordlist.txt into `trie`, or maps wordlist.dawg when it's there and up to date. with `letters_on_board` the
+// words that board can't spell with `swaps` swaps are left out, without it the dictionary works for any board.
+// what it did and how long it took goes to `log`
+static void load_dictionary(const Options& options, const LetterHistogram* letters_on_board, int swaps, Trie& trie, std::optional<Dawg>& dawg, std::ostream& log) {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!options.compile)
+        dawg = Dawg::load("wordlist.dawg", "wordlist.txt");
+
+    // a compiled dictionary has to work on every board, so only drop words when building for this one
+    const bool prefilter = letters_on_board && !options.compile;
+
+    // read in one go and cut into words in place, extracting them one by one with >> costs more than filtering them
+    std::ifstream wordlist_file("wordlist.txt", std::ios::binary);
+    std::string wordlist;
+    if (!dawg && wordlist_file.seekg(0, std::ios::end)) {
+        wordlist.resize(wordlist_file.tellg());
+        wordlist_file.seekg(0).read(wordlist.data(), wordlist.size());
+    }
+    constexpr auto is_space = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; };
+
+    for (auto it = wordlist.begin(); it != wordlist.end();) {
+        it = std::find_if_not(it, wordlist.end(), is_space);
+        const auto word_end = std::find_if(it, wordlist.end(), is_space);
+        const std::string_view word(it, word_end);
+        it = word_end;
+
+        if (word.empty() || std::ranges::any_of(word, [](const auto& c) { return !std::isalpha(c); }))
+            continue;
+        if (prefilter && impossible_word(word, *letters_on_board, swaps))
+            continue;
+
+        trie.TrieInsert(word);
+    }
+    trie.compact();
+
+    if (dawg) {
+        log << std::format("dawg: mapped wordlist.dawg, {} nodes, {}KB", dawg->nodes.size(), dawg->bytes() / 1024) << std::endl;
+    } else if (options.dawg || options.compile) {
+        dawg = Dawg::build(trie);
+        log << std::format("dawg: {} nodes, {}KB (trie: {} nodes, {}KB)", dawg->nodes.size(), dawg->bytes() / 1024, trie.nodes.size(), trie.bytes() / 1024) << std::endl;
+        trie = {};
+        if (options.compile)
+            dawg->save("wordlist.dawg", "wordlist.txt");
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    log << std::format("elapsed time: {}ms", elapsed.count() / 1000.) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const Options options = parse_options(argc, argv);
+    // replies are all a --serve client reads on stdout, the rest goes to stderr then
+    std::ostream& log = options.serve.empty() ? std::cout : std::cerr;
+    log << "STARTED PROGRAM" << std::endl;
+    Trie trie;
+    std::optional<Dawg> dawg;
+    const Dictionary dictionary{trie, dawg};
+
+    // one dictionary for whatever boards come in, so nothing can be left out up front
+    if (!options.serve.empty()) {
+        load_dictionary(options, nullptr, 0, trie, dawg, log);
+        serve(dictionary, options, options.serve);
+        return 0;
+    }
+
+    Board board = parse_board_from_file();
+
+    std::ifstream swaps_file("swaps.txt");
+    std::ifstream eco_file("eco.txt");
+    const int swaps = std::stoi(std::string{std::istreambuf_iterator<char>(swaps_file), std::istreambuf_iterator<char>()});
+    bool eco_mode = std::stoi(std::string{std::istreambuf_iterator<char>(eco_file), std::istreambuf_iterator<char>()});
+    [[unlikely]] if (swaps > PackedPath::max_swaps) {
+        throw std::runtime_error("too many swaps");
+    }
+
+    const LetterHistogram letters_on_board = board_histogram(board);
+    load_dictionary(options, &letters_on_board, swaps, trie, dawg, log);
+
+    std::vector<Path> biggest_words = {{{{0, 0, 'e'}}}};
+    int max_eco_score = 0;
+    int max_score = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::optional<Deadline> deadline;
+    if (options.deadline.count() > 0)
+        deadline.emplace(options.deadline);
+    const SearchConfig config{swaps, eco_mode, options.threads, options.engine, options.reach_prune, options.order, deadline ? &*deadline : nullptr, options.top, options.pareto, options.weights, options.deepen};
+
+    if (options.bench) {
+        // every engine on the same board and dictionary, one after the other, they have to agree on the best word
+        for (const auto& [engine, name] : {std::pair{Engine::Recursive, "recursive"}, {Engine::Iterative, "iterative"}, {Engine::Breadth, "breadth"}}) {
+            SearchConfig bench_config = config;
+            bench_config.engine = engine;
+            // each engine gets the whole time budget, not what the one before it left over
+            std::optional<Deadline> bench_deadline;
+            if (options.deadline.count() > 0)
+                bench_config.deadline = &bench_deadline.emplace(options.deadline);
+            const auto bench_start = std::chrono::high_resolution_clock::now();
+            const Solution solution = dictionary.solve(board, bench_config);
+            const auto bench_end = std::chrono::high_resolution_clock::now();
+            const auto bench_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(bench_end - bench_start);
+            std::cout << std::format("bench {}: {}ms, max score {}, max eco score {}, {} words{}", name, bench_elapsed.count() / 1000., solution.max_score, solution.max_eco_score, solution.words.size(),
+                                     bench_deadline && bench_deadline->expired() ? ", stopped by the deadline" : "")
+                      << std::endl;
+        }
+        return 0;
+    }
+
+    Solution solution = dictionary.solve(board, config);
+    if (!solution.words.empty()) {
+        biggest_words = std::move(solution.words);
+        max_score = solution.max_score;
+        max_eco_score = solution.max_eco_score;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << std::format("elapsed time: {}ms", elapsed.count() / 1000.) << std::endl;
+
+    print_biggest_word(board, biggest_words, options.pareto ? biggest_words.size() : std::max<size_t>(options.top, 10));
+    // one line per trade-off, most points first
+    if (options.pareto)
+        for (const Path& path : std::views::reverse(biggest_words)) {
+            std::string word;
+            int swapped = 0;
+            for (auto [x, y, c] : path) {
+                word += c;
+                swapped += c != std::get<0>(board[x][y]) ? 1 : 0;
+            }
+            std::cout << std::format("pareto: {} points, {} gems, {} swaps: {}", score(board, path), gems(board, path), swapped, word) << std::endl;
+        }
+    std::cout << "max score: " << max_score << std::endl;
+    std::cout << "max eco score: " << max_eco_score << std::endl;
+    if (options.weights && !options.pareto) {
+        const Path& best_word = options.top > 1 ? biggest_words.back() : biggest_words.front();
+        const auto swapped = std::ranges::count_if(best_word, [&](const auto& tile) {
+            auto [x, y, c] = tile;
+            return c != std::get<0>(board[x][y]);
+        });
+        std::cout << std::format("weighted value: {}", max_score + options.weights->gem * max_eco_score - options.weights->swap * swapped) << std::endl;
+    }
+    // a search the deadline stopped may have missed something better
+    if (deadline)
+        std::cout << "proven optimal: " << (deadline->expired() ? "no" : "yes") << std::endl;
     return 0;
 }